@@ -0,0 +1,434 @@
+#include "AllocTracker.h"
+
+#if HAPPY_ALLOC_TRACKING
+
+#    include <algorithm>
+#    include <atomic>
+#    include <cstdlib>
+#    include <cstring>
+#    include <new>
+#    include <vector>
+
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#        define ALLOC_RETURN_ADDRESS() reinterpret_cast<uintptr_t>(_ReturnAddress())
+#    else
+#        define ALLOC_RETURN_ADDRESS() reinterpret_cast<uintptr_t>(__builtin_return_address(0))
+#    endif
+
+#    if __has_include(<dlfcn.h>) && __has_include(<cxxabi.h>)
+#        define ALLOC_HAS_DLADDR 1
+#        include <cxxabi.h>
+#        include <dlfcn.h>
+#    endif
+
+namespace
+{
+// Everything touched from operator new is zero-initialized static storage: no allocation, no init order issues
+struct ScopeEntry
+{
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> bytes;
+};
+
+struct SiteEntry
+{
+    std::atomic<uintptr_t> address;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> bytes;
+};
+
+constexpr size_t MAX_SCOPES      = 64;
+constexpr size_t MAX_SITES       = 4096;
+constexpr size_t MAX_SITE_PROBES = 16;
+constexpr int MAX_SCOPE_DEPTH    = 16;
+
+ScopeEntry s_scopes[MAX_SCOPES];
+SiteEntry s_sites[MAX_SITES];
+std::atomic<uint64_t> s_allocations;
+std::atomic<uint64_t> s_bytes;
+std::atomic<uint64_t> s_scopedAllocations;
+std::atomic<uint64_t> s_scopedBytes;
+std::atomic<uint64_t> s_scopeEntries;
+std::atomic<bool> s_gateFailed;
+
+thread_local int t_scopeStack[MAX_SCOPE_DEPTH];
+thread_local int t_scopeDepth;
+thread_local bool t_suspended;
+
+AllocTracker* s_sharedAllocTracker = nullptr;
+
+// Keeps the tracker's own bookkeeping (reports, logging) out of the numbers
+struct SuspendTracking
+{
+    bool previous;
+    SuspendTracking() : previous(t_suspended) { t_suspended = true; }
+    ~SuspendTracking() { t_suspended = previous; }
+};
+
+int findScope(const char* name)
+{
+    for (size_t i = 0; i < MAX_SCOPES; ++i)
+    {
+        const char* current = s_scopes[i].name.load(std::memory_order_acquire);
+        if (!current)
+        {
+            if (s_scopes[i].name.compare_exchange_strong(current, name, std::memory_order_acq_rel))
+            {
+                return static_cast<int>(i);
+            }
+        }
+        if (current == name || (current && strcmp(current, name) == 0))
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void recordSite(uintptr_t address, size_t size)
+{
+    size_t slot = (address >> 4) * 0x9E3779B97F4A7C15ull % MAX_SITES;
+    for (size_t probe = 0; probe < MAX_SITE_PROBES; ++probe, slot = (slot + 1) % MAX_SITES)
+    {
+        auto& site         = s_sites[slot];
+        uintptr_t existing = site.address.load(std::memory_order_relaxed);
+        if (existing == 0 && site.address.compare_exchange_strong(existing, address, std::memory_order_relaxed))
+        {
+            existing = address;
+        }
+        if (existing == address)
+        {
+            site.allocations.fetch_add(1, std::memory_order_relaxed);
+            site.bytes.fetch_add(size, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void recordAllocation(size_t size, uintptr_t returnAddress)
+{
+    if (t_suspended)
+    {
+        return;
+    }
+
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (t_scopeDepth > 0 && t_scopeDepth <= MAX_SCOPE_DEPTH)
+    {
+        int scope = t_scopeStack[t_scopeDepth - 1];
+        if (scope >= 0)
+        {
+            s_scopes[scope].allocations.fetch_add(1, std::memory_order_relaxed);
+            s_scopes[scope].bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+        s_scopedAllocations.fetch_add(1, std::memory_order_relaxed);
+        s_scopedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    recordSite(returnAddress, size);
+}
+
+std::string describeSite(uintptr_t address)
+{
+#    if ALLOC_HAS_DLADDR
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(address), &info) && info.dli_sname)
+    {
+        int status      = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name(status == 0 && demangled ? demangled : info.dli_sname);
+        free(demangled);
+        return ax::StringUtils::format("%s+0x%zx", name.c_str(),
+                                       static_cast<size_t>(address - reinterpret_cast<uintptr_t>(info.dli_saddr)));
+    }
+#    endif
+    return ax::StringUtils::format("0x%zx", static_cast<size_t>(address));
+}
+
+AllocTracker::Stats currentTotals()
+{
+    return AllocTracker::Stats{s_allocations.load(std::memory_order_relaxed), s_bytes.load(std::memory_order_relaxed)};
+}
+
+AllocTracker::Stats currentScopedTotals()
+{
+    return AllocTracker::Stats{s_scopedAllocations.load(std::memory_order_relaxed),
+                               s_scopedBytes.load(std::memory_order_relaxed)};
+}
+}  // namespace
+
+AllocTracker* AllocTracker::getInstance()
+{
+    if (!s_sharedAllocTracker)
+    {
+        s_sharedAllocTracker = new AllocTracker();
+    }
+    return s_sharedAllocTracker;
+}
+
+AllocTracker::AllocTracker()
+    : _frameStart(currentTotals())
+    , _frameStartScoped(currentScopedTotals())
+    , _gateWarmupFrames(0)
+    , _gateTotalFrames(0)
+    , _gatedFrames(0)
+    , _gateEnabled(false)
+{
+    // Never destroyed: main() still needs the gate result after the Director is gone
+    ax::Director::getInstance()->getEventDispatcher()->addCustomEventListener(
+        ax::Director::EVENT_AFTER_DRAW, [this](ax::EventCustom*) { onFrameEnd(); });
+}
+
+void AllocTracker::pushScope(const char* name)
+{
+    if (t_scopeDepth < MAX_SCOPE_DEPTH)
+    {
+        SuspendTracking suspend;
+        t_scopeStack[t_scopeDepth] = findScope(name);
+    }
+    ++t_scopeDepth;
+    s_scopeEntries.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocTracker::popScope()
+{
+    --t_scopeDepth;
+}
+
+void AllocTracker::enableZeroAllocGate(uint32_t warmupFrames, uint32_t totalFrames)
+{
+    _gateEnabled      = true;
+    _gateWarmupFrames = warmupFrames;
+    _gateTotalFrames  = std::max(totalFrames, warmupFrames + 1);
+    _gatedFrames      = 0;
+    AXLOGI("Zero-allocation gate: {} warm-up frames, {} frames total", _gateWarmupFrames, _gateTotalFrames);
+}
+
+bool AllocTracker::hasGateFailed()
+{
+    return s_gateFailed.load();
+}
+
+void AllocTracker::onFrameEnd()
+{
+    SuspendTracking suspend;
+
+    static uint64_t lastScopeEntries = 0;
+    bool gameplayRan                 = s_scopeEntries.load(std::memory_order_relaxed) != lastScopeEntries;
+    lastScopeEntries                 = s_scopeEntries.load(std::memory_order_relaxed);
+
+    Stats now          = currentTotals();
+    Stats nowScoped    = currentScopedTotals();
+    _lastFrame         = Stats{now.allocations - _frameStart.allocations, now.bytes - _frameStart.bytes};
+    _lastFrameScoped   = Stats{nowScoped.allocations - _frameStartScoped.allocations,
+                             nowScoped.bytes - _frameStartScoped.bytes};
+    _frameStart        = now;
+    _frameStartScoped  = nowScoped;
+    if (_lastFrame.allocations > _peakFrame.allocations)
+    {
+        _peakFrame = _lastFrame;
+    }
+
+    if (!_gateEnabled || !gameplayRan)
+    {
+        return;
+    }
+
+    ++_gatedFrames;
+    if (_gatedFrames > _gateWarmupFrames && _lastFrameScoped.allocations > 0 && !s_gateFailed.load())
+    {
+        s_gateFailed = true;
+        AXLOGE("Zero-allocation gate FAILED at gated frame {}: {} allocations, {} bytes in gameplay scopes\n{}",
+               _gatedFrames, _lastFrameScoped.allocations, _lastFrameScoped.bytes, getReport());
+    }
+
+    if (_gatedFrames >= _gateTotalFrames || s_gateFailed.load())
+    {
+        if (!s_gateFailed.load())
+        {
+            AXLOGI("Zero-allocation gate passed: {} steady-state frames without gameplay allocations",
+                   _gatedFrames - _gateWarmupFrames);
+        }
+        writeReport();
+        _gateEnabled = false;
+        ax::Director::getInstance()->end();
+    }
+}
+
+std::string AllocTracker::getReport(size_t topCallSites) const
+{
+    SuspendTracking suspend;
+
+    Stats total = currentTotals();
+    std::string report =
+        ax::StringUtils::format("allocations %llu bytes %llu | last frame %llu (%llu bytes) | peak frame %llu (%llu bytes)\n",
+                                (unsigned long long)total.allocations, (unsigned long long)total.bytes,
+                                (unsigned long long)_lastFrame.allocations, (unsigned long long)_lastFrame.bytes,
+                                (unsigned long long)_peakFrame.allocations, (unsigned long long)_peakFrame.bytes);
+
+    report += "scope allocations bytes\n";
+    for (const auto& scope : s_scopes)
+    {
+        if (const char* name = scope.name.load())
+        {
+            report += ax::StringUtils::format("%s %llu %llu\n", name, (unsigned long long)scope.allocations.load(),
+                                              (unsigned long long)scope.bytes.load());
+        }
+    }
+
+    std::vector<const SiteEntry*> sites;
+    for (const auto& site : s_sites)
+    {
+        if (site.address.load())
+        {
+            sites.push_back(&site);
+        }
+    }
+    std::sort(sites.begin(), sites.end(),
+              [](const SiteEntry* a, const SiteEntry* b) { return a->allocations.load() > b->allocations.load(); });
+
+    report += "call_site allocations bytes\n";
+    for (size_t i = 0; i < std::min(topCallSites, sites.size()); ++i)
+    {
+        report += ax::StringUtils::format("%s %llu %llu\n", describeSite(sites[i]->address.load()).c_str(),
+                                          (unsigned long long)sites[i]->allocations.load(),
+                                          (unsigned long long)sites[i]->bytes.load());
+    }
+    return report;
+}
+
+bool AllocTracker::writeReport() const
+{
+    SuspendTracking suspend;
+    auto fileUtils = ax::FileUtils::getInstance();
+    return fileUtils->writeStringToFile(getReport(20), fileUtils->getWritablePath() + "alloc_report.txt");
+}
+
+// Global replacements. Plain allocations use malloc/free, over-aligned ones the platform aligned allocator.
+
+void* operator new(size_t size)
+{
+    recordAllocation(size, ALLOC_RETURN_ADDRESS());
+    if (void* p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    recordAllocation(size, ALLOC_RETURN_ADDRESS());
+    if (void* p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    recordAllocation(size, ALLOC_RETURN_ADDRESS());
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    recordAllocation(size, ALLOC_RETURN_ADDRESS());
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    free(p);
+}
+
+static void* alignedAllocate(size_t size, std::align_val_t alignment)
+{
+    size_t align = static_cast<size_t>(alignment);
+#    if defined(_MSC_VER)
+    return _aligned_malloc(size ? size : 1, align);
+#    else
+    return aligned_alloc(align, (std::max(size, size_t(1)) + align - 1) / align * align);
+#    endif
+}
+
+static void alignedFree(void* p)
+{
+#    if defined(_MSC_VER)
+    _aligned_free(p);
+#    else
+    free(p);
+#    endif
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    recordAllocation(size, ALLOC_RETURN_ADDRESS());
+    if (void* p = alignedAllocate(size, alignment))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    recordAllocation(size, ALLOC_RETURN_ADDRESS());
+    if (void* p = alignedAllocate(size, alignment))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+#endif  // HAPPY_ALLOC_TRACKING
@@ -0,0 +1,86 @@
+#pragma once
+
+/**
+@brief  Opt-in heap allocation profiler, built with -DHAPPY_ALLOC_TRACKING=ON.
+
+Replaces the global operator new/delete to count allocations and bytes per frame,
+per instrumented scope and per call site. Mark gameplay code with ALLOC_SCOPE();
+the macro compiles to nothing when tracking is off.
+
+The zero-allocation gate turns this into a test: after a warm-up, any allocation
+made inside an instrumented scope fails the run and main() returns non-zero.
+*/
+#if HAPPY_ALLOC_TRACKING
+
+#    include "axmol/axmol.h"
+
+#    include <cstdint>
+#    include <string>
+
+class AllocTracker
+{
+public:
+    struct Stats
+    {
+        uint64_t allocations = 0;
+        uint64_t bytes       = 0;
+    };
+
+    static AllocTracker* getInstance();
+
+    /** Whole-process allocations of the last completed frame, and the worst frame so far. */
+    const Stats& getLastFrame() const { return _lastFrame; }
+    const Stats& getPeakFrame() const { return _peakFrame; }
+
+    /** Allocations made inside ALLOC_SCOPE()s during the last completed frame. */
+    const Stats& getLastFrameScoped() const { return _lastFrameScoped; }
+
+    /** Per-scope totals and the top `topCallSites` allocating call sites. */
+    std::string getReport(size_t topCallSites = 10) const;
+    bool writeReport() const;
+
+    /**
+    @brief  Fail the run if instrumented scopes allocate in steady state.
+    @param warmupFrames  Frames allowed to allocate while pools and buffers grow.
+    @param totalFrames   Gated frames to run before quitting.
+    */
+    void enableZeroAllocGate(uint32_t warmupFrames, uint32_t totalFrames);
+    static bool hasGateFailed();
+
+    // Used by ALLOC_SCOPE()
+    static void pushScope(const char* name);
+    static void popScope();
+
+private:
+    AllocTracker();
+    void onFrameEnd();
+
+    Stats _frameStart;
+    Stats _frameStartScoped;
+    Stats _lastFrame;
+    Stats _lastFrameScoped;
+    Stats _peakFrame;
+    uint32_t _gateWarmupFrames;
+    uint32_t _gateTotalFrames;
+    uint32_t _gatedFrames;
+    bool _gateEnabled;
+};
+
+class AllocScope
+{
+public:
+    explicit AllocScope(const char* name) { AllocTracker::pushScope(name); }
+    ~AllocScope() { AllocTracker::popScope(); }
+    AllocScope(const AllocScope&)            = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+};
+
+#    define ALLOC_SCOPE_CONCAT2(a, b) a##b
+#    define ALLOC_SCOPE_CONCAT(a, b)  ALLOC_SCOPE_CONCAT2(a, b)
+#    define ALLOC_SCOPE(name)         AllocScope ALLOC_SCOPE_CONCAT(allocScope, __LINE__)(name)
+
+#else
+
+#    define ALLOC_SCOPE(name)
+
+#endif
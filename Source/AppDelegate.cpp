@@ -1,5 +1,20 @@
 #include "AppDelegate.h"
+#include "AllocTracker.h"
+#include "AudioStartup.h"
+#include "FramePacer.h"
+#include "FrameTelemetry.h"
+#include "GameConfig.h"
+#include "ImageTier.h"
+#include "Inspector.h"
+#include "LatencyTracker.h"
+#include "LeaderboardClient.h"
 #include "MainScene.h"
+#include "MemoryBudget.h"
+#include "MusicStream.h"
+#include "ParticlePack.h"
+#include "SfxCache.h"
+#include "StaticLayer.h"
+#include "VersusScene.h"
 
 #define USE_VR_RENDERER  0
 #define USE_AUDIO_ENGINE 1
@@ -15,6 +30,101 @@
 
 static ax::Size designResolutionSize = ax::Size(768, 1280);
 
+// TextureCache only reports itself as text: one `"path" rc=N ... => N KB` line per texture
+static size_t forEachCachedTexture(const std::function<void(std::string_view path, int refs)>& visitor)
+{
+    std::string info = ax::Director::getInstance()->getTextureCache()->getCachedTextureInfo();
+    size_t bytes     = 0;
+    size_t start     = 0;
+    while (start < info.size())
+    {
+        size_t end = info.find('\n', start);
+        end        = end == std::string::npos ? info.size() : end;
+        std::string_view line(info.data() + start, end - start);
+        start = end + 1;
+
+        size_t nameEnd = line.size() > 1 && line[0] == '"' ? line.find('"', 1) : std::string_view::npos;
+        size_t refsAt  = line.find("rc=");
+        size_t sizeAt  = line.find("=> ");
+        if (nameEnd == std::string_view::npos || refsAt == std::string_view::npos || sizeAt == std::string_view::npos)
+        {
+            continue;
+        }
+        bytes += size_t(atol(line.data() + sizeAt + 3)) * 1024;
+        if (visitor)
+        {
+            visitor(line.substr(1, nameEnd - 1), atoi(line.data() + refsAt + 3));
+        }
+    }
+    return bytes;
+}
+
+// The loads finish through the scheduler, so the frame pacer is kept awake until the last one is in
+static void reloadTextures(const std::shared_ptr<std::vector<std::string>>& evicted)
+{
+    if (evicted->empty())
+    {
+        return;
+    }
+
+    // The counter doubles as the busy owner, so overlapping reloads do not release each other
+    auto pending      = std::make_shared<size_t>(evicted->size());
+    auto textureCache = ax::Director::getInstance()->getTextureCache();
+    FramePacer::getInstance()->setBusy(pending.get(), true);
+    for (const auto& path : *evicted)
+    {
+        textureCache->addImageAsync(path, [pending](ax::Texture2D*) {
+            if (--*pending == 0)
+            {
+                FramePacer::getInstance()->setBusy(pending.get(), false);
+            }
+        });
+    }
+    evicted->clear();
+}
+
+static void registerMemoryBudget()
+{
+    using AssetClass = MemoryBudget::AssetClass;
+    auto budget      = MemoryBudget::getInstance();
+
+    budget->registerClass(AssetClass::StaticLayers,
+                          {&StaticLayer::getResidentBytes, &StaticLayer::releaseAllCaches, nullptr});
+    budget->registerClass(AssetClass::Particles, {[] { return ParticlePack::getInstance()->getResidentBytes(); },
+                                                  [] { ParticlePack::getInstance()->purge(); },
+                                                  [] { ParticlePack::getInstance()->reload(); }});
+    // Axmol has no accessor for atlas sizes; labels regenerate their glyphs on the next draw
+    budget->registerClass(AssetClass::Fonts, {nullptr, [] { ax::FontAtlasCache::purgeCachedData(); }, nullptr});
+    // Nothing is loaded, and AudioEngine must not be touched, while the device is still opening
+    budget->registerClass(AssetClass::Audio, {[] { return SfxCache::getInstance()->getResidentBytes(); },
+                                              [] {
+                                                  if (!AudioStartup::getInstance()->isPending())
+                                                  {
+                                                      SfxCache::getInstance()->purge();
+                                                  }
+                                              },
+                                              [] {
+                                                  if (AudioStartup::getInstance()->isReady())
+                                                  {
+                                                      SfxCache::getInstance()->reload();
+                                                  }
+                                              }});
+
+    // Textures nothing else holds are what removeUnusedTextures() drops; bring those back off the main thread
+    auto evicted = std::make_shared<std::vector<std::string>>();
+    budget->registerClass(AssetClass::Textures, {[] { return forEachCachedTexture(nullptr); },
+                                                 [evicted] {
+                                                     forEachCachedTexture([&](std::string_view path, int refs) {
+                                                         if (refs == 1)
+                                                         {
+                                                             evicted->emplace_back(path);
+                                                         }
+                                                     });
+                                                     ax::Director::getInstance()->getTextureCache()->removeUnusedTextures();
+                                                 },
+                                                 [evicted] { reloadTextures(evicted); }});
+}
+
 
 // if you want a different context, modify the value of contextAttrs
 // it will affect all platforms
@@ -28,6 +138,12 @@ void AppDelegate::initContextAttrs()
     // Uncomment to disable V-Sync and unlock FPS.
     // contextAttrs.vsync = false;
 
+    // Stress runs measure how much work fits in a frame, not the display's refresh rate
+    if (GameConfig::getInstance()->stress)
+    {
+        contextAttrs.vsync = false;
+    }
+
     // Enable high-DPI scaling support (non-Windows platforms only)
     // Note: cpp-tests keep the default render mode to ensure consistent performance benchmarks
 #if AX_TARGET_PLATFORM != AX_PLATFORM_WIN32
@@ -67,40 +183,69 @@ bool AppDelegate::applicationDidFinishLaunching()
     std::vector<std::string> searchPaths;
     searchPaths.push_back("sounds");
     searchPaths.push_back("particles");
+#ifdef HAPPY_GENERATED_CONTENT
+    // Build artifacts such as particles.pak stay in the build tree; see CMakeLists.txt
+    searchPaths.push_back(HAPPY_GENERATED_CONTENT);
+#endif
 
-    if (screenSize.height > 800)
-    {
-        // High Resolution
-        searchPaths.push_back("images/high");
-        director->setContentScaleFactor(1280.0f / designSize.height);
-    }
-    else if (screenSize.height > 600)
-    {
-        // Mid resolution
-        searchPaths.push_back("images/mid");
-        director->setContentScaleFactor(800.0f / designSize.height);
-    }
-    else
-    {
-        // Low resolution
-        searchPaths.push_back("images/low");
-        director->setContentScaleFactor(320.0f / designSize.height);
-    }
+    // Picks images/low|mid|high for the window; the tier can change later under pressure
+    ImageTier::getInstance()->init(screenSize.height, designSize.height, searchPaths);
     ax::FileUtils::getInstance()->setSearchPaths(searchPaths);
+
+    // Opening the device can take hundreds of milliseconds; it overlaps with loading and building the first scene
+    AudioStartup::getInstance()->begin({"bomb.mp3", "uh.mp3"});
+
+    // Precompiled by tools/compile_particles.py; scenes fall back to the plists when it is missing
+    ParticlePack::getInstance()->load("particles.pak");
+    registerMemoryBudget();
     glview->setDesignResolutionSize(designSize.width, designSize.height, ax::ResolutionPolicy::SHOW_ALL);
 
     // turn on display FPS
     director->setStatsDisplay(true);
 
     // set FPS. the default value is 1.0/60 if you don't call this
-    director->setAnimationInterval(1.0f / 60);
+    // Go through the pacer so idle scenes (Pause, GameOver) can stop redrawing and come back at this rate
+    FramePacer::getInstance()->setAnimationInterval(1.0f / 60);
+
+    // The stats overlay only shows the current rate; this keeps the stutters, per scene
+    FrameTelemetry::getInstance()->start(*GameConfig::getInstance());
+#if HAPPY_INSPECTOR
+    // The same and more, live on the device; it follows the running scene from the first one on
+    Inspector::getInstance()->start(*GameConfig::getInstance());
+#endif
 
     // Set the design resolution
     renderView->setDesignResolutionSize(designResolutionSize.width, designResolutionSize.height,
                                         ax::ResolutionPolicy::SHOW_ALL);
 
+#if HAPPY_ALLOC_TRACKING
+    // Count allocations from the first frame on. The gate's warm-up covers pool growth and the renderer's first frames
+    auto allocTracker = AllocTracker::getInstance();
+    if (auto gateFrames = GameConfig::getInstance()->zeroAllocGateFrames)
+    {
+        allocTracker->enableZeroAllocGate(120, gateFrames);
+    }
+#else
+    // Platforms without a main() of ours cannot fail the exit code, so at least do not run forever
+    if (GameConfig::getInstance()->zeroAllocGateFrames > 0)
+    {
+        AXLOGE("--zero-alloc-gate needs a build configured with -DHAPPY_ALLOC_TRACKING=ON");
+        director->end();
+        return true;
+    }
+#endif
+
+    // Sends scores left over from earlier sessions, too
+    LeaderboardClient::getInstance()->setUrl(GameConfig::getInstance()->leaderboardUrl);
+
+    if (float quitAfter = GameConfig::getInstance()->quitAfter; quitAfter > 0.0f)
+    {
+        director->getScheduler()->schedule([](float) { ax::Director::getInstance()->end(); }, this, 0.0f, 0,
+                                           quitAfter, false, "quitAfter");
+    }
+
     // create a scene. it's an autorelease object
-    auto scene = MainScene::createScene();
+    auto scene = GameConfig::getInstance()->versus ? VersusScene::createScene() : MainScene::createScene();
 
     // run
     director->runWithScene(scene);
@@ -111,21 +256,70 @@ bool AppDelegate::applicationDidFinishLaunching()
 // This function will be called when the app is inactive. Note, when receiving a phone call it is invoked.
 void AppDelegate::applicationDidEnterBackground()
 {
-    ax::Director::getInstance()->stopAnimation();
+    auto director = ax::Director::getInstance();
+    director->stopAnimation();
+
+    // Scenes snapshot whatever they cannot afford to lose if the OS kills us now
+    director->getEventDispatcher()->dispatchCustomEvent(EVENT_DID_ENTER_BACKGROUND);
+
+    // We may never come back, so keep what this session measured
+    LatencyTracker::getInstance()->writeReport();
+    FrameTelemetry::getInstance()->flush();
+    FrameTelemetry::getInstance()->writeReport();
 
+    MusicStream::setAllSuspended(true);
+    if (AudioStartup::getInstance()->isReady())
+    {
 #if USE_AUDIO_ENGINE
-    ax::AudioEngine::pauseAll();
+        ax::AudioEngine::pauseAll();
 #endif
+        SfxCache::getInstance()->stopAll();
+    }
+
+    // Give the OS back what we can rebuild, so it has less reason to kill us
+    MemoryBudget::getInstance()->onEnterBackground();
 }
 
 // this function will be called when the app is active again
 void AppDelegate::applicationWillEnterForeground()
 {
-    ax::Director::getInstance()->startAnimation();
+    auto director = ax::Director::getInstance();
+    director->startAnimation();
+    director->getEventDispatcher()->dispatchCustomEvent(EVENT_WILL_ENTER_FOREGROUND);
 
 #if USE_AUDIO_ENGINE
-    ax::AudioEngine::resumeAll();
+    if (AudioStartup::getInstance()->isReady())
+    {
+        ax::AudioEngine::resumeAll();
+    }
 #endif
+    MusicStream::setAllSuspended(false);
+    MemoryBudget::getInstance()->onEnterForeground();
+
+    // A tier dropped for memory comes back with a fresh start; one dropped for heat waits to cool down
+    ImageTier::getInstance()->restorePreferred();
 }
 
-void AppDelegate::applicationWillQuit() {}
+void AppDelegate::applicationWillQuit()
+{
+#if HAPPY_ALLOC_TRACKING
+    AllocTracker::getInstance()->writeReport();
+#endif
+    LatencyTracker::getInstance()->writeReport();
+    LatencyTracker::destroyInstance();
+    FrameTelemetry::getInstance()->flush();
+    FrameTelemetry::getInstance()->writeReport();
+    FrameTelemetry::destroyInstance();
+#if HAPPY_INSPECTOR
+    Inspector::destroyInstance();
+#endif
+    MemoryBudget::getInstance()->writeReport();
+    MemoryBudget::destroyInstance();
+    LeaderboardClient::getInstance()->writeReport();
+    LeaderboardClient::destroyInstance();
+    FramePacer::destroyInstance();
+    ParticlePack::destroyInstance();
+    SfxCache::destroyInstance();
+    AudioStartup::destroyInstance();
+    ImageTier::destroyInstance();
+}
@@ -10,6 +10,10 @@ Private inheritance here hides part of interface from Director.
 class AppDelegate : private ax::Application
 {
 public:
+    /** Custom events dispatched to scenes, which cannot see Application callbacks themselves. */
+    static constexpr const char* EVENT_DID_ENTER_BACKGROUND  = "app_did_enter_background";
+    static constexpr const char* EVENT_WILL_ENTER_FOREGROUND = "app_will_enter_foreground";
+
     AppDelegate() = default;
     ~AppDelegate() override = default;
 
@@ -0,0 +1,149 @@
+#include "AudioStartup.h"
+#include "SfxCache.h"
+#include "axmol/audio/AudioEngine.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+AudioStartup* s_sharedAudioStartup = nullptr;
+
+uint64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+}  // namespace
+
+AudioStartup* AudioStartup::getInstance()
+{
+    if (!s_sharedAudioStartup)
+    {
+        s_sharedAudioStartup = new AudioStartup();
+    }
+    return s_sharedAudioStartup;
+}
+
+void AudioStartup::destroyInstance()
+{
+    delete s_sharedAudioStartup;
+    s_sharedAudioStartup = nullptr;
+}
+
+AudioStartup::AudioStartup() : _state(State::Idle), _queuedEffectCount(0), _startedAt(0) {}
+
+AudioStartup::~AudioStartup()
+{
+    // Quitting during startup still has to wait for the device; AudioEngine::end() cannot run under lazyInit()
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
+void AudioStartup::begin(std::vector<std::string> effects)
+{
+    if (_state != State::Idle)
+    {
+        return;
+    }
+
+    _state     = State::Pending;
+    _effects   = std::move(effects);
+    _startedAt = nowUs();
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_WASM
+    // No threads to hide it on; WebAudio contexts open quickly anyway
+    finish(ax::AudioEngine::lazyInit());
+#else
+    _thread = std::thread([] {
+        bool opened = ax::AudioEngine::lazyInit();
+        ax::Director::getInstance()->getScheduler()->runOnAxmolThread([opened] {
+            // Gone if the app quit while the device was opening
+            if (s_sharedAudioStartup)
+            {
+                s_sharedAudioStartup->finish(opened);
+            }
+        });
+    });
+#endif
+}
+
+void AudioStartup::finish(bool opened)
+{
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+
+    std::vector<Task> tasks;
+    tasks.swap(_tasks);
+    if (!opened)
+    {
+        AXLOGE("AudioStartup: cannot open the audio device, the game stays silent");
+        _state             = State::Failed;
+        _queuedEffectCount = 0;
+        return;
+    }
+
+    _state = State::Ready;
+    AXLOGI("AudioStartup: device open after {} ms", (nowUs() - _startedAt) / 1000);
+
+    // Decoded once into the writable path; later launches only map the PCM
+    auto sfx = SfxCache::getInstance();
+    for (const auto& effect : _effects)
+    {
+        sfx->preload(effect);
+    }
+    sfx->prune();
+
+    for (size_t i = 0; i < _queuedEffectCount; ++i)
+    {
+        sfx->play(_queuedEffects[i].filename, _queuedEffects[i].volume);
+    }
+    _queuedEffectCount = 0;
+
+    for (auto& task : tasks)
+    {
+        task.run();
+    }
+}
+
+void AudioStartup::whenReady(const void* owner, std::function<void()> task)
+{
+    switch (_state)
+    {
+    case State::Idle:
+    case State::Pending:
+        _tasks.push_back(Task{owner, std::move(task)});
+        break;
+    case State::Ready:
+        task();
+        break;
+    default:
+        break;
+    }
+}
+
+void AudioStartup::cancel(const void* owner)
+{
+    _tasks.erase(std::remove_if(_tasks.begin(), _tasks.end(), [owner](const Task& task) { return task.owner == owner; }),
+                 _tasks.end());
+}
+
+void AudioStartup::queueEffect(std::string_view filename, float volume)
+{
+    for (size_t i = 0; i < _queuedEffectCount; ++i)
+    {
+        if (_queuedEffects[i].filename == filename)
+        {
+            return;
+        }
+    }
+    if (_queuedEffectCount < _queuedEffects.size())
+    {
+        _queuedEffects[_queuedEffectCount++] = QueuedEffect{std::string(filename), volume};
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "axmol/axmol.h"
+
+#include <array>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+@brief  Opens the audio device on a background thread so launch never waits for it.
+
+begin() runs AudioEngine::lazyInit() on its own thread; on some Linux and
+Android audio stacks that alone takes hundreds of milliseconds. When it returns,
+the main thread preloads the effects given to begin() (cheap, they come from
+SfxCache's PCM cache), plays the effects that were requested in the meantime and
+runs the tasks queued with whenReady().
+
+Until then nothing may touch AudioEngine or OpenAL: SfxCache::play() queues
+through queueEffect(), and other callers check isPending() first.
+*/
+class AudioStartup
+{
+public:
+    static AudioStartup* getInstance();
+    static void destroyInstance();
+
+    /** Start opening the device and preload `effects` once it is up. Later calls do nothing. */
+    void begin(std::vector<std::string> effects);
+
+    /** The device is still being opened. */
+    bool isPending() const { return _state == State::Pending; }
+
+    /** The device is open; false while pending and after a failure. */
+    bool isReady() const { return _state == State::Ready; }
+
+    /**
+    @brief  Run `task` on the main thread once the device is up, or right away if it is.
+    Dropped if the device cannot be opened. cancel(owner) drops what `owner` queued.
+    */
+    void whenReady(const void* owner, std::function<void()> task);
+    void cancel(const void* owner);
+
+    /**
+    @brief  Play an effect as soon as the device is up.
+    Each effect is queued once; repeats in the meantime would only play on top of each other.
+    */
+    void queueEffect(std::string_view filename, float volume);
+
+    ~AudioStartup();
+
+private:
+    enum class State
+    {
+        Idle,
+        Pending,
+        Ready,
+        Failed,
+    };
+
+    struct Task
+    {
+        const void* owner;
+        std::function<void()> run;
+    };
+
+    struct QueuedEffect
+    {
+        std::string filename;
+        float volume;
+    };
+
+    AudioStartup();
+    void finish(bool opened);
+
+    State _state;
+    std::thread _thread;
+    std::vector<std::string> _effects;
+    std::vector<Task> _tasks;
+    std::array<QueuedEffect, 4> _queuedEffects;
+    size_t _queuedEffectCount;
+    uint64_t _startedAt;  // for the log, microseconds
+};
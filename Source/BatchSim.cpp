@@ -0,0 +1,203 @@
+#include "BatchSim.h"
+#include "Percentile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+// The design resolution and the high tier's sprite sizes, in points. The other tiers are exported at the same
+// point sizes, so a headless round collides like a live one in any tier to within a pixel of rounding.
+const ax::Size FIELD_SIZE(768, 1280);
+const ax::Size PLAYER_SIZE(130, 253);
+const ax::Size BOMB_SIZE(92, 120);
+
+// MainScene::autoplay runs at the same rate
+constexpr float BOT_INTERVAL = 0.1f;
+
+// Common random numbers: round i draws the same spawns in every set
+uint64_t seedOf(uint64_t baseSeed, size_t round)
+{
+    return baseSeed + round * 0x9E3779B97F4A7C15ull;
+}
+}  // namespace
+
+BatchSim::BatchSim(const GameConfig& config) : _config(config) {}
+
+// Cartesian product of the sweeps, applied on top of the base config
+bool BatchSim::buildParameterSets()
+{
+    std::vector<GameConfig> configs{_config};
+    std::vector<std::string> labels{""};
+    for (const auto& sweep : _config.simSweeps)
+    {
+        auto colon = sweep.find(':');
+        if (colon == std::string::npos)
+        {
+            fprintf(stderr, "sim-sweep needs name:value,value,... got '%s'\n", sweep.c_str());
+            return false;
+        }
+        std::string name = sweep.substr(0, colon);
+
+        std::vector<GameConfig> nextConfigs;
+        std::vector<std::string> nextLabels;
+        size_t start = colon + 1;
+        while (start <= sweep.size())
+        {
+            size_t end        = std::min(sweep.find(',', start), sweep.size());
+            std::string value = sweep.substr(start, end - start);
+            start             = end + 1;
+            for (size_t i = 0; i < configs.size(); ++i)
+            {
+                GameConfig config = configs[i];
+                if (!config.set(name, value))
+                {
+                    fprintf(stderr, "sim-sweep: unknown option '%s'\n", name.c_str());
+                    return false;
+                }
+                nextConfigs.push_back(config);
+                nextLabels.push_back(labels[i] + (labels[i].empty() ? "" : " ") + name + "=" + value);
+            }
+        }
+        configs.swap(nextConfigs);
+        labels.swap(nextLabels);
+    }
+
+    for (size_t i = 0; i < configs.size(); ++i)
+    {
+        _sets.push_back(ParameterSet{labels[i].empty() ? "base" : labels[i], GameRules::fromConfig(configs[i]),
+                                     configs[i].simBotSkill});
+    }
+    return true;
+}
+
+BatchSim::RoundResult BatchSim::playRound(const ParameterSet& set, uint64_t seed) const
+{
+    GameRound round;
+    round.setRules(set.rules);
+    round.setField(FIELD_SIZE, PLAYER_SIZE, BOMB_SIZE);
+    round.setSeed(seed);
+    round.reset();
+
+    // The bot has its own generator, so its misses do not change what the round spawns
+    Rng botRng(~seed);
+    float botTimer = 0.0f;
+    while (round.getElapsed() < _config.simMaxSeconds && round.step(_config.simStep))
+    {
+        botTimer += _config.simStep;
+        if (botTimer < BOT_INTERVAL)
+        {
+            continue;
+        }
+        botTimer -= BOT_INTERVAL;
+        if (botRng.next01() >= set.botSkill)
+        {
+            continue;
+        }
+
+        GameRound::BotMove move = round.suggestBotMove();
+        if (move.tap)
+        {
+            round.tap(move.tapAt);
+        }
+        if (move.drag)
+        {
+            round.dragPlayer(move.dragTo);
+        }
+    }
+    return RoundResult{std::min(round.getElapsed(), _config.simMaxSeconds), round.getScore(),
+                       round.getBombsTapped()};
+}
+
+bool BatchSim::run()
+{
+    if (_config.simStep <= 0.0f || !buildParameterSets())
+    {
+        return false;
+    }
+
+    const size_t rounds = _config.simRounds;
+    const size_t total  = _sets.size() * rounds;
+    _results.resize(total);
+
+    unsigned threads = _config.simThreads ? _config.simThreads : std::max(1u, std::thread::hardware_concurrency());
+    threads          = static_cast<unsigned>(std::min<size_t>(threads, total));
+
+    const uint64_t baseSeed = _config.seed ? _config.seed : 1;
+    printf("Simulating %zu rounds (%zu sets x %zu) on %u threads\n", total, _sets.size(), rounds, threads);
+
+    // Rounds take wildly different times, so workers pull the next one instead of getting fixed slices
+    std::atomic<size_t> next{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&] {
+            for (size_t job = next++; job < total; job = next++)
+            {
+                _results[job] = playRound(_sets[job / rounds], seedOf(baseSeed, job % rounds));
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::string report = buildReport(wallSeconds, threads);
+
+    auto fileUtils   = ax::FileUtils::getInstance();
+    std::string path = _config.simReport.empty() ? fileUtils->getWritablePath() + "sim_report.txt"
+                                                 : _config.simReport;
+    printf("%s\nSimulation report written to %s\n", report.c_str(), path.c_str());
+    return fileUtils->writeStringToFile(report, path);
+}
+
+std::string BatchSim::buildReport(double wallSeconds, unsigned threads)
+{
+    const size_t rounds = _config.simRounds;
+    double simSeconds   = 0.0;
+    for (const auto& result : _results)
+    {
+        simSeconds += result.survived;
+    }
+
+    std::string report;
+    report += ax::StringUtils::format("rounds: %zu\n", _results.size());
+    report += ax::StringUtils::format("threads: %u\n", threads);
+    report += ax::StringUtils::format("wall_seconds: %.2f\n", wallSeconds);
+    report += ax::StringUtils::format("rounds_per_second: %.1f\n", _results.size() / std::max(wallSeconds, 1e-9));
+    report += ax::StringUtils::format("times_real_time: %.0f\n", simSeconds / std::max(wallSeconds, 1e-9));
+    report += ax::StringUtils::format("step: %.4f max_seconds: %.0f\n", _config.simStep, _config.simMaxSeconds);
+
+    report += "\nset bot_skill survived_mean survived_p10 survived_p50 survived_p90 survived_max_pct "
+              "score_mean score_p10 score_p50 score_p90 taps_mean\n";
+    std::vector<float> survived(rounds);
+    std::vector<float> scores(rounds);
+    for (size_t set = 0; set < _sets.size(); ++set)
+    {
+        double survivedSum = 0.0, scoreSum = 0.0, tapSum = 0.0;
+        size_t capped      = 0;
+        for (size_t i = 0; i < rounds; ++i)
+        {
+            const RoundResult& result = _results[set * rounds + i];
+            survived[i]               = result.survived;
+            scores[i]                 = static_cast<float>(result.score);
+            survivedSum += result.survived;
+            scoreSum += result.score;
+            tapSum += result.bombsTapped;
+            capped += result.survived >= _config.simMaxSeconds ? 1 : 0;
+        }
+
+        report += ax::StringUtils::format(
+            "\"%s\" %.2f %.1f %.1f %.1f %.1f %.1f %.0f %.0f %.0f %.0f %.1f\n", _sets[set].label.c_str(),
+            _sets[set].botSkill, survivedSum / rounds, percentileOf(survived, 0.10f), percentileOf(survived, 0.50f),
+            percentileOf(survived, 0.90f), 100.0 * capped / rounds, scoreSum / rounds, percentileOf(scores, 0.10f),
+            percentileOf(scores, 0.50f), percentileOf(scores, 0.90f), tapSum / rounds);
+    }
+    return report;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "GameConfig.h"
+#include "GameRound.h"
+
+#include <string>
+#include <vector>
+
+/**
+@brief  Plays many headless rounds on every core to see how the gameplay options play out.
+
+Each parameter set is the base config with one value from every `sim-sweep`
+applied, so two sweeps of three values give nine sets. Every set plays
+`sim-rounds` rounds of the real GameRound rules at a fixed step, as fast as the
+CPU allows, with the bot MainScene uses for autoplay; `sim-bot-skill` is the
+chance it acts on each decision, so it can be made to miss like a person. Round
+i gets the same seed in every set, so sets differ only by their options.
+
+The report has survival-time and score percentiles per set, and rounds per
+second and the speed-up over real time as throughput.
+*/
+class BatchSim
+{
+public:
+    explicit BatchSim(const GameConfig& config);
+
+    /** Play every round and write the report. @return false if the options were unusable. */
+    bool run();
+
+private:
+    struct ParameterSet
+    {
+        std::string label;  // the swept options, e.g. "spawn-interval=6 wave-size=4"
+        GameRules rules;
+        float botSkill;
+    };
+
+    struct RoundResult
+    {
+        float survived;  // seconds, capped at sim-max-seconds
+        int score;
+        uint32_t bombsTapped;
+    };
+
+    bool buildParameterSets();
+    RoundResult playRound(const ParameterSet& set, uint64_t seed) const;
+    std::string buildReport(double wallSeconds, unsigned threads);
+
+    const GameConfig& _config;
+    std::vector<ParameterSet> _sets;
+    std::vector<RoundResult> _results;  // set-major: _sets.size() * sim-rounds entries
+};
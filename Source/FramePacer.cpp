@@ -0,0 +1,188 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+
+namespace
+{
+// Frames the idle scene must stay still before we stop drawing, so the final state is presented
+constexpr int QUIET_FRAMES_BEFORE_SLEEP = 3;
+
+FramePacer* s_sharedFramePacer = nullptr;
+}  // namespace
+
+FramePacer* FramePacer::getInstance()
+{
+    if (!s_sharedFramePacer)
+    {
+        s_sharedFramePacer = new FramePacer();
+    }
+    return s_sharedFramePacer;
+}
+
+void FramePacer::destroyInstance()
+{
+    delete s_sharedFramePacer;
+    s_sharedFramePacer = nullptr;
+}
+
+FramePacer::FramePacer()
+    : _director(ax::Director::getInstance())
+    , _idleScene(nullptr)
+    , _touchListener(nullptr)
+    , _mouseListener(nullptr)
+    , _keyboardListener(nullptr)
+    , _projectionListener(nullptr)
+    , _interval(1.0f / 60)
+    , _idlePollInterval(1.0f / 30)
+    , _quietFrames(0)
+    , _wakeCount(0)
+    , _sleeping(false)
+{
+    auto dispatcher = _director->getEventDispatcher();
+
+    // Fixed-priority listeners see every event before the scene and never claim it
+    _touchListener               = ax::EventListenerTouchOneByOne::create();
+    _touchListener->onTouchBegan = [this](ax::Touch*, ax::Event*) {
+        wake();
+        return true;
+    };
+    _touchListener->onTouchMoved = [this](ax::Touch*, ax::Event*) { wake(); };
+    _touchListener->onTouchEnded = [this](ax::Touch*, ax::Event*) { wake(); };
+    dispatcher->addEventListenerWithFixedPriority(_touchListener, -1);
+
+    _mouseListener                = ax::EventListenerMouse::create();
+    _mouseListener->onMouseDown   = [this](ax::EventMouse*) { wake(); };
+    _mouseListener->onMouseUp     = [this](ax::EventMouse*) { wake(); };
+    _mouseListener->onMouseScroll = [this](ax::EventMouse*) { wake(); };
+    dispatcher->addEventListenerWithFixedPriority(_mouseListener, -1);
+
+    _keyboardListener               = ax::EventListenerKeyboard::create();
+    _keyboardListener->onKeyPressed = [this](ax::EventKeyboard::KeyCode, ax::Event*) { wake(); };
+    dispatcher->addEventListenerWithFixedPriority(_keyboardListener, -1);
+
+    // Resolution or projection changes invalidate whatever was presented last
+    _projectionListener =
+        dispatcher->addCustomEventListener(ax::Director::EVENT_PROJECTION_CHANGED, [this](ax::EventCustom*) { wake(); });
+
+    _director->getScheduler()->schedule([this](float) { onFrame(); }, this, 0.0f, false, "FramePacer");
+}
+
+FramePacer::~FramePacer()
+{
+    _director->getScheduler()->unschedule("FramePacer", this);
+
+    auto dispatcher = _director->getEventDispatcher();
+    dispatcher->removeEventListener(_touchListener);
+    dispatcher->removeEventListener(_mouseListener);
+    dispatcher->removeEventListener(_keyboardListener);
+    dispatcher->removeEventListener(_projectionListener);
+
+    if (_sleeping)
+    {
+        _director->startAnimation();
+    }
+}
+
+void FramePacer::setAnimationInterval(float interval)
+{
+    _interval = interval;
+    _director->setAnimationInterval(interval);
+}
+
+void FramePacer::setSceneIdle(ax::Scene* scene, bool idle)
+{
+    if (idle)
+    {
+        _idleScene   = scene;
+        _quietFrames = 0;
+    }
+    else if (_idleScene == scene)
+    {
+        _idleScene = nullptr;
+        wake();
+    }
+}
+
+void FramePacer::setBusy(const void* owner, bool busy)
+{
+    auto found = std::find(_busyOwners.begin(), _busyOwners.end(), owner);
+    if (busy)
+    {
+        if (found == _busyOwners.end())
+        {
+            _busyOwners.push_back(owner);
+        }
+        wake();
+    }
+    else if (found != _busyOwners.end())
+    {
+        _busyOwners.erase(found);
+    }
+}
+
+void FramePacer::invalidate()
+{
+    wake();
+}
+
+void FramePacer::onFrame()
+{
+    // Ticking while asleep means someone else restarted animation (e.g. returning from background)
+    if (_sleeping)
+    {
+        _sleeping = false;
+        ++_wakeCount;
+    }
+
+    auto scene = _director->getRunningScene();
+    if (!_idleScene || scene != _idleScene || !_busyOwners.empty() || hasRunningActions(scene))
+    {
+        _quietFrames = 0;
+        return;
+    }
+
+    if (++_quietFrames >= QUIET_FRAMES_BEFORE_SLEEP)
+    {
+        sleep();
+    }
+}
+
+void FramePacer::sleep()
+{
+    _sleeping = true;
+    _director->stopAnimation();
+
+    // The scheduler stops with the animation, which is why busy owners keep us awake; keep pumping platform
+    // events at a low rate for wake-ups
+    ax::Application::getInstance()->setAnimationInterval(_idlePollInterval);
+}
+
+void FramePacer::wake()
+{
+    _quietFrames = 0;
+    if (!_sleeping)
+    {
+        return;
+    }
+
+    _sleeping = false;
+    ++_wakeCount;
+    _director->setAnimationInterval(_interval);
+    _director->startAnimation();
+}
+
+bool FramePacer::hasRunningActions(ax::Node* node) const
+{
+    if (node->getNumberOfRunningActions() > 0)
+    {
+        return true;
+    }
+    for (auto child : node->getChildren())
+    {
+        if (hasRunningActions(child))
+        {
+            return true;
+        }
+    }
+    return false;
+}
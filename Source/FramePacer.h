@@ -0,0 +1,74 @@
+#pragma once
+
+#include "axmol/axmol.h"
+
+#include <vector>
+
+/**
+@brief  Frame-pacing policy that stops redrawing scenes with nothing to animate.
+
+A scene declares itself idle (typically from onEnterTransitionDidFinish) and the
+pacer stops animation once that scene has no running actions for a few frames.
+Input, invalidate() or leaving the scene starts animation again at the rate
+given to setAnimationInterval(), so push/pop/replace always restore it.
+
+While asleep the Director does not tick the scheduler either, so nothing
+scheduled or queued with runOnAxmolThread runs, and neither do async texture
+loads or HttpClient responses. Systems with such work outstanding mark
+themselves busy with setBusy(), which keeps the pacer awake until they are done.
+*/
+class FramePacer
+{
+public:
+    static FramePacer* getInstance();
+    static void destroyInstance();
+
+    /** Interval used while awake. Use this instead of Director::setAnimationInterval(). */
+    void setAnimationInterval(float interval);
+    float getAnimationInterval() const { return _interval; }
+
+    /** How often platform events are still polled while asleep, where the platform loop allows it. */
+    void setIdlePollInterval(float interval) { _idlePollInterval = interval; }
+
+    /**
+    @brief  Mark `scene` as idle, or clear it.
+    Only the running scene matters; clearing wakes the pacer so the next scene gets drawn.
+    */
+    void setSceneIdle(ax::Scene* scene, bool idle);
+
+    /**
+    @brief  Keep drawing, and so ticking the scheduler, while `owner` has work for the main thread.
+    Marking busy wakes the pacer. Main thread only.
+    */
+    void setBusy(const void* owner, bool busy);
+
+    /** Draw at least a few more frames, e.g. after changing something by hand. */
+    void invalidate();
+
+    bool isSleeping() const { return _sleeping; }
+
+    /** Times drawing restarted after a sleep; the gap before such a frame says nothing about frame time. */
+    uint32_t getWakeCount() const { return _wakeCount; }
+
+    ~FramePacer();
+
+private:
+    FramePacer();
+    void onFrame();
+    void sleep();
+    void wake();
+    bool hasRunningActions(ax::Node* node) const;
+
+    ax::Director* _director;
+    ax::Scene* _idleScene;
+    std::vector<const void*> _busyOwners;
+    ax::EventListenerTouchOneByOne* _touchListener;
+    ax::EventListenerMouse* _mouseListener;
+    ax::EventListenerKeyboard* _keyboardListener;
+    ax::EventListenerCustom* _projectionListener;
+    float _interval;
+    float _idlePollInterval;
+    int _quietFrames;
+    uint32_t _wakeCount;
+    bool _sleeping;
+};
@@ -0,0 +1,347 @@
+#include "FrameTelemetry.h"
+#include "FramePacer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+namespace
+{
+FrameTelemetry* s_sharedFrameTelemetry = nullptr;
+
+// statsd keys are <prefix>.<scene>.<metric>.<stat>
+constexpr const char* STATSD_PREFIX = "happyaxmol";
+
+uint64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+float toMs(uint64_t us)
+{
+    return static_cast<float>(us) / 1000.0f;
+}
+
+const char* metricName(FrameTelemetry::Metric metric)
+{
+    switch (metric)
+    {
+    case FrameTelemetry::Metric::Frame:
+        return "frame";
+    case FrameTelemetry::Metric::Update:
+        return "update";
+    default:
+        return "render";
+    }
+}
+}  // namespace
+
+FrameTelemetry* FrameTelemetry::getInstance()
+{
+    if (!s_sharedFrameTelemetry)
+    {
+        s_sharedFrameTelemetry = new FrameTelemetry();
+    }
+    return s_sharedFrameTelemetry;
+}
+
+void FrameTelemetry::destroyInstance()
+{
+    delete s_sharedFrameTelemetry;
+    s_sharedFrameTelemetry = nullptr;
+}
+
+FrameTelemetry::FrameTelemetry()
+    : _sceneCount(0)
+    , _beforeUpdateListener(nullptr)
+    , _afterUpdateListener(nullptr)
+    , _beforeDrawListener(nullptr)
+    , _afterDrawListener(nullptr)
+    , _interval(10.0f)
+    , _budgetMs(0.0f)
+    , _updateStart(0)
+    , _drawStart(0)
+    , _lastFrameEnd(0)
+    , _windowStart(0)
+    , _wakeCount(0)
+    , _statsd(false)
+{
+}
+
+FrameTelemetry::~FrameTelemetry()
+{
+    if (!_afterDrawListener)
+    {
+        return;
+    }
+
+    auto dispatcher = ax::Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_beforeUpdateListener);
+    dispatcher->removeEventListener(_afterUpdateListener);
+    dispatcher->removeEventListener(_beforeDrawListener);
+    dispatcher->removeEventListener(_afterDrawListener);
+}
+
+void FrameTelemetry::start(const GameConfig& config)
+{
+    if (!config.telemetry || _afterDrawListener)
+    {
+        return;
+    }
+
+    _interval = std::max(config.telemetryInterval, 1.0f);
+    _budgetMs = config.telemetryBudgetMs;
+    _filePath = config.telemetryFile.empty()
+                    ? ax::FileUtils::getInstance()->getWritablePath() + "frame_telemetry.txt"
+                    : config.telemetryFile;
+
+    if (!config.telemetryStatsd.empty())
+    {
+        auto colon       = config.telemetryStatsd.rfind(':');
+        std::string host = config.telemetryStatsd.substr(0, colon);
+        int port         = colon == std::string::npos ? 0 : atoi(config.telemetryStatsd.c_str() + colon + 1);
+        if (host == "localhost")
+        {
+            host = "127.0.0.1";
+        }
+
+        if (port > 0 && port < 65536 && _statsdSocket.open(AF_INET, SOCK_DGRAM))
+        {
+            // Exports run on the main thread; a full socket buffer drops a window instead of stalling a frame
+            _statsdSocket.set_nonblocking(true);
+            _statsdEndpoint = yasio::ip::endpoint(host.c_str(), static_cast<unsigned short>(port));
+            _statsd         = true;
+        }
+        else
+        {
+            AXLOGE("telemetry-statsd needs ip:port, got '{}'; writing to {} instead", config.telemetryStatsd,
+                   _filePath);
+        }
+    }
+
+    auto dispatcher       = ax::Director::getInstance()->getEventDispatcher();
+    _beforeUpdateListener = dispatcher->addCustomEventListener(ax::Director::EVENT_BEFORE_UPDATE,
+                                                               [this](ax::EventCustom*) { onBeforeUpdate(); });
+    _afterUpdateListener  = dispatcher->addCustomEventListener(ax::Director::EVENT_AFTER_UPDATE,
+                                                               [this](ax::EventCustom*) { onAfterUpdate(); });
+    _beforeDrawListener   = dispatcher->addCustomEventListener(ax::Director::EVENT_BEFORE_DRAW,
+                                                               [this](ax::EventCustom*) { onBeforeDraw(); });
+    _afterDrawListener =
+        dispatcher->addCustomEventListener(ax::Director::EVENT_AFTER_DRAW, [this](ax::EventCustom*) { onAfterDraw(); });
+
+    _windowStart = nowUs();
+    AXLOGI("Frame telemetry: {}s windows to {}", _interval, _statsd ? config.telemetryStatsd : _filePath);
+}
+
+void FrameTelemetry::onBeforeUpdate()
+{
+    _updateStart = nowUs();
+}
+
+// The Director only updates while it is not paused, so a frame may have a render time and no update time
+void FrameTelemetry::onAfterUpdate()
+{
+    if (_updateStart != 0)
+    {
+        statsFor(ax::Director::getInstance()->getRunningScene())
+            .window[static_cast<size_t>(Metric::Update)]
+            .record(nowUs() - _updateStart);
+        _updateStart = 0;
+    }
+}
+
+void FrameTelemetry::onBeforeDraw()
+{
+    _drawStart = nowUs();
+}
+
+void FrameTelemetry::onAfterDraw()
+{
+    uint64_t now      = nowUs();
+    SceneStats& stats = statsFor(ax::Director::getInstance()->getRunningScene());
+    if (_drawStart != 0)
+    {
+        stats.window[static_cast<size_t>(Metric::Render)].record(now - _drawStart);
+        _drawStart = 0;
+    }
+
+    // A frame right after the pacer woke up follows a deliberate pause, not a slow frame
+    uint32_t wakeCount = FramePacer::getInstance()->getWakeCount();
+    if (_lastFrameEnd != 0 && wakeCount == _wakeCount)
+    {
+        stats.window[static_cast<size_t>(Metric::Frame)].record(now - _lastFrameEnd);
+    }
+    _wakeCount    = wakeCount;
+    _lastFrameEnd = now;
+
+    if (static_cast<float>(now - _windowStart) / 1.0e6f >= _interval)
+    {
+        exportWindow();
+    }
+}
+
+FrameTelemetry::SceneStats& FrameTelemetry::statsFor(ax::Scene* scene)
+{
+    std::string_view name = "Other";
+    if (dynamic_cast<ax::TransitionScene*>(scene))
+    {
+        name = "Transition";
+    }
+    else if (scene && !scene->getName().empty())
+    {
+        name = scene->getName();
+    }
+
+    for (size_t i = 0; i < _sceneCount; ++i)
+    {
+        if (_scenes[i].name == name)
+        {
+            return _scenes[i];
+        }
+    }
+    if (_sceneCount == MAX_SCENES)
+    {
+        return _scenes[MAX_SCENES - 1];
+    }
+    _scenes[_sceneCount].name = name;
+    return _scenes[_sceneCount++];
+}
+
+uint64_t FrameTelemetry::budgetUs(Metric metric) const
+{
+    float budgetMs = _budgetMs > 0.0f ? _budgetMs : FramePacer::getInstance()->getAnimationInterval() * 1000.0f;
+    if (metric == Metric::Frame)
+    {
+        // Presentation snaps to the display's refresh, so a frame is late once it took another half interval
+        budgetMs *= 1.5f;
+    }
+    return static_cast<uint64_t>(budgetMs * 1000.0f);
+}
+
+void FrameTelemetry::flush()
+{
+    if (!_afterDrawListener)
+    {
+        return;
+    }
+
+    exportWindow();
+    _updateStart  = 0;
+    _drawStart    = 0;
+    _lastFrameEnd = 0;
+}
+
+void FrameTelemetry::exportWindow()
+{
+    std::string lines;
+    long long timestamp = static_cast<long long>(std::time(nullptr));
+    for (size_t i = 0; i < _sceneCount; ++i)
+    {
+        SceneStats& stats = _scenes[i];
+        for (size_t m = 0; m < stats.window.size(); ++m)
+        {
+            const HdrHistogram& histogram = stats.window[m];
+            if (histogram.count() == 0)
+            {
+                continue;
+            }
+            lines += ax::StringUtils::format(
+                "t=%lld scene=%s metric=%s count=%llu p50=%.2f p90=%.2f p99=%.2f max=%.2f over_budget=%llu\n",
+                timestamp, stats.name.c_str(), metricName(static_cast<Metric>(m)),
+                static_cast<unsigned long long>(histogram.count()), toMs(histogram.percentile(0.50f)),
+                toMs(histogram.percentile(0.90f)), toMs(histogram.percentile(0.99f)), toMs(histogram.max()),
+                static_cast<unsigned long long>(histogram.countAbove(budgetUs(static_cast<Metric>(m)))));
+        }
+
+        if (_statsd)
+        {
+            sendToStatsd(stats);
+        }
+        for (size_t m = 0; m < stats.window.size(); ++m)
+        {
+            stats.session[m].add(stats.window[m]);
+            stats.window[m].reset();
+        }
+    }
+
+    if (!_statsd && !lines.empty())
+    {
+        appendToFile(lines);
+    }
+    _windowStart = nowUs();
+}
+
+void FrameTelemetry::appendToFile(const std::string& lines) const
+{
+    FILE* file = fopen(_filePath.c_str(), "a");
+    if (!file)
+    {
+        AXLOGE("Cannot append frame telemetry to {}", _filePath);
+        return;
+    }
+    fwrite(lines.data(), 1, lines.size(), file);
+    fclose(file);
+}
+
+// One datagram per scene, one stat per line; statsd listeners split on newlines
+void FrameTelemetry::sendToStatsd(const SceneStats& stats)
+{
+    std::string packet;
+    for (size_t m = 0; m < stats.window.size(); ++m)
+    {
+        const HdrHistogram& histogram = stats.window[m];
+        if (histogram.count() == 0)
+        {
+            continue;
+        }
+
+        std::string key = ax::StringUtils::format("%s.%s.%s", STATSD_PREFIX, stats.name.c_str(),
+                                                  metricName(static_cast<Metric>(m)));
+        packet += ax::StringUtils::format("%s.p50:%.2f|g\n", key.c_str(), toMs(histogram.percentile(0.50f)));
+        packet += ax::StringUtils::format("%s.p90:%.2f|g\n", key.c_str(), toMs(histogram.percentile(0.90f)));
+        packet += ax::StringUtils::format("%s.p99:%.2f|g\n", key.c_str(), toMs(histogram.percentile(0.99f)));
+        packet += ax::StringUtils::format("%s.max:%.2f|g\n", key.c_str(), toMs(histogram.max()));
+        packet += ax::StringUtils::format("%s.count:%llu|c\n", key.c_str(),
+                                          static_cast<unsigned long long>(histogram.count()));
+        packet += ax::StringUtils::format(
+            "%s.over_budget:%llu|c\n", key.c_str(),
+            static_cast<unsigned long long>(histogram.countAbove(budgetUs(static_cast<Metric>(m)))));
+    }
+
+    if (!packet.empty())
+    {
+        packet.pop_back();
+        _statsdSocket.sendto(packet.data(), static_cast<int>(packet.size()), _statsdEndpoint);
+    }
+}
+
+bool FrameTelemetry::writeReport() const
+{
+    std::string report = ax::StringUtils::format("budget_ms: update/render %.2f frame %.2f\n",
+                                                 toMs(budgetUs(Metric::Update)), toMs(budgetUs(Metric::Frame)));
+    report += "scene metric count p50_ms p90_ms p99_ms max_ms over_budget\n";
+    for (size_t i = 0; i < _sceneCount; ++i)
+    {
+        const SceneStats& stats = _scenes[i];
+        for (size_t m = 0; m < stats.session.size(); ++m)
+        {
+            // Include the window that has not been exported yet
+            HdrHistogram histogram = stats.session[m];
+            histogram.add(stats.window[m]);
+            if (histogram.count() == 0)
+            {
+                continue;
+            }
+            report += ax::StringUtils::format(
+                "%s %s %llu %.2f %.2f %.2f %.2f %llu\n", stats.name.c_str(), metricName(static_cast<Metric>(m)),
+                static_cast<unsigned long long>(histogram.count()), toMs(histogram.percentile(0.50f)),
+                toMs(histogram.percentile(0.90f)), toMs(histogram.percentile(0.99f)), toMs(histogram.max()),
+                static_cast<unsigned long long>(histogram.countAbove(budgetUs(static_cast<Metric>(m)))));
+        }
+    }
+
+    auto fileUtils = ax::FileUtils::getInstance();
+    return fileUtils->writeStringToFile(report, fileUtils->getWritablePath() + "frame_report.txt");
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "axmol/axmol.h"
+#include "GameConfig.h"
+#include "HdrHistogram.h"
+#include "yasio/xxsocket.hpp"
+
+#include <array>
+#include <string>
+
+/**
+@brief  Always-on frame, update and render time histograms per scene, exported periodically.
+
+Frame time is the interval between two presented frames. Update time is the
+scheduler tick and render time is the scene draw. Each goes into an HdrHistogram
+of the scene that was running, which is keyed by the scene's name; transitions
+count as "Transition".
+
+Every `telemetry-interval` seconds the window's p50, p90, p99, max and
+over-budget count are appended to `telemetry-file` or sent as statsd gauges to
+`telemetry-statsd`, and the window is folded into the session totals that
+writeReport() writes. Over budget means an update or render longer than the
+budget, or a frame interval over 1.5 budgets, i.e. a missed refresh.
+*/
+class FrameTelemetry
+{
+public:
+    enum class Metric
+    {
+        Frame,
+        Update,
+        Render,
+        Count,
+    };
+
+    static FrameTelemetry* getInstance();
+    static void destroyInstance();
+
+    /** Start recording with the telemetry-* options. Does nothing if `telemetry` is off. */
+    void start(const GameConfig& config);
+
+    /**
+    @brief  Export the current window now, e.g. when going to the background or quitting.
+    The gap until the next frame is left out of the frame times.
+    */
+    void flush();
+
+    /** Write the session totals per scene to frame_report.txt in the writable path. */
+    bool writeReport() const;
+
+    ~FrameTelemetry();
+
+private:
+    static constexpr size_t MAX_SCENES = 6;  // MainScene, Pause, GameOver, Transition, and room for more
+
+    struct SceneStats
+    {
+        std::string name;
+        std::array<HdrHistogram, static_cast<size_t>(Metric::Count)> window;
+        std::array<HdrHistogram, static_cast<size_t>(Metric::Count)> session;
+    };
+
+    FrameTelemetry();
+    void onBeforeUpdate();
+    void onAfterUpdate();
+    void onBeforeDraw();
+    void onAfterDraw();
+    SceneStats& statsFor(ax::Scene* scene);
+    uint64_t budgetUs(Metric metric) const;
+    void exportWindow();
+    void appendToFile(const std::string& lines) const;
+    void sendToStatsd(const SceneStats& stats);
+
+    std::array<SceneStats, MAX_SCENES> _scenes;
+    size_t _sceneCount;
+    ax::EventListenerCustom* _beforeUpdateListener;
+    ax::EventListenerCustom* _afterUpdateListener;
+    ax::EventListenerCustom* _beforeDrawListener;
+    ax::EventListenerCustom* _afterDrawListener;
+    std::string _filePath;
+    yasio::xxsocket _statsdSocket;
+    yasio::ip::endpoint _statsdEndpoint;
+    float _interval;
+    float _budgetMs;
+    uint64_t _updateStart;
+    uint64_t _drawStart;
+    uint64_t _lastFrameEnd;
+    uint64_t _windowStart;
+    uint32_t _wakeCount;
+    bool _statsd;
+};
@@ -0,0 +1,310 @@
+#include "GameConfig.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace
+{
+std::string_view trim(std::string_view text)
+{
+    const char* whitespace = " \t\r\n";
+    auto first             = text.find_first_not_of(whitespace);
+    if (first == std::string_view::npos)
+    {
+        return {};
+    }
+    return text.substr(first, text.find_last_not_of(whitespace) - first + 1);
+}
+
+float toFloat(std::string_view value, float fallback)
+{
+    std::string text(value);
+    char* end    = nullptr;
+    float result = strtof(text.c_str(), &end);
+    return end != text.c_str() ? result : fallback;
+}
+
+uint32_t toUint(std::string_view value, uint32_t fallback)
+{
+    std::string text(value);
+    char* end              = nullptr;
+    unsigned long result   = strtoul(text.c_str(), &end, 10);
+    return end != text.c_str() ? static_cast<uint32_t>(result) : fallback;
+}
+
+bool toBool(std::string_view value)
+{
+    return value.empty() || value == "1" || value == "true" || value == "on" || value == "yes";
+}
+}  // namespace
+
+GameConfig* GameConfig::getInstance()
+{
+    static GameConfig instance;
+    return &instance;
+}
+
+void GameConfig::parseCommandLine(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg(argv[i]);
+        if (arg.substr(0, 2) != "--")
+        {
+            continue;
+        }
+        arg = arg.substr(2);
+
+        std::string_view value;
+        if (auto equals = arg.find('='); equals != std::string_view::npos)
+        {
+            value = arg.substr(equals + 1);
+            arg   = arg.substr(0, equals);
+        }
+
+        if (arg == "config")
+        {
+            if (!loadFile(value))
+            {
+                fprintf(stderr, "Cannot read config file %.*s\n", static_cast<int>(value.size()), value.data());
+            }
+        }
+        else if (!set(arg, value))
+        {
+            // A typo must not quietly turn an unattended run into a default one
+            fprintf(stderr, "Unknown option --%.*s\n", static_cast<int>(arg.size()), arg.data());
+        }
+    }
+}
+
+bool GameConfig::loadFile(std::string_view path)
+{
+    std::ifstream file{std::string(path)};
+    if (!file)
+    {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::string_view text = line;
+        text                  = trim(text.substr(0, text.find('#')));
+        if (text.empty())
+        {
+            continue;
+        }
+
+        std::string_view name = text;
+        std::string_view value;
+        if (auto equals = text.find('='); equals != std::string_view::npos)
+        {
+            name  = trim(text.substr(0, equals));
+            value = trim(text.substr(equals + 1));
+        }
+        if (!set(name, value))
+        {
+            fprintf(stderr, "Unknown option '%.*s' in %.*s\n", static_cast<int>(name.size()), name.data(),
+                    static_cast<int>(path.size()), path.data());
+        }
+    }
+    return true;
+}
+
+bool GameConfig::set(std::string_view name, std::string_view value)
+{
+    if (name == "spawn-interval")
+    {
+        spawnInterval = toFloat(value, spawnInterval);
+    }
+    else if (name == "wave-size")
+    {
+        waveSize = toUint(value, waveSize);
+    }
+    else if (name == "wave-stagger")
+    {
+        waveStagger = toFloat(value, waveStagger);
+    }
+    else if (name == "min-speed")
+    {
+        minSpeed = toFloat(value, minSpeed);
+    }
+    else if (name == "max-speed")
+    {
+        maxSpeed = toFloat(value, maxSpeed);
+    }
+    else if (name == "score-interval")
+    {
+        scoreInterval = toFloat(value, scoreInterval);
+    }
+    else if (name == "score-per-tick")
+    {
+        scorePerTick = static_cast<int>(toUint(value, scorePerTick));
+    }
+    else if (name == "invulnerable")
+    {
+        invulnerable = toBool(value);
+    }
+    else if (name == "seed")
+    {
+        seed = strtoull(std::string(value).c_str(), nullptr, 10);
+    }
+    else if (name == "static-cache")
+    {
+        staticCache = toBool(value);
+    }
+    else if (name == "gpu-bomb-motion")
+    {
+        gpuBombMotion = toBool(value);
+    }
+    else if (name == "threaded-sim")
+    {
+        threadedSim = toBool(value);
+    }
+    else if (name == "threaded-sim-hz")
+    {
+        threadedSimHz = toFloat(value, threadedSimHz);
+    }
+    else if (name == "telemetry")
+    {
+        telemetry = toBool(value);
+    }
+    else if (name == "telemetry-interval")
+    {
+        telemetryInterval = toFloat(value, telemetryInterval);
+    }
+    else if (name == "telemetry-budget-ms")
+    {
+        telemetryBudgetMs = toFloat(value, telemetryBudgetMs);
+    }
+    else if (name == "telemetry-file")
+    {
+        telemetryFile = std::string(value);
+    }
+    else if (name == "telemetry-statsd")
+    {
+        telemetryStatsd = std::string(value);
+    }
+    else if (name == "leaderboard-url")
+    {
+        leaderboardUrl = std::string(value);
+    }
+    else if (name == "versus")
+    {
+        versus = toBool(value);
+    }
+    else if (name == "versus-frames")
+    {
+        versusFrames = toUint(value, versusFrames);
+    }
+    else if (name == "versus-transport")
+    {
+        versusTransport = std::string(value);
+    }
+    else if (name == "versus-port")
+    {
+        versusPort = toUint(value, versusPort);
+    }
+    else if (name == "versus-delay")
+    {
+        versusDelay = toUint(value, versusDelay);
+    }
+    else if (name == "versus-rollback")
+    {
+        versusRollback = toUint(value, versusRollback);
+    }
+    else if (name == "versus-latency-ms")
+    {
+        versusLatencyMs = toFloat(value, versusLatencyMs);
+    }
+    else if (name == "versus-jitter-ms")
+    {
+        versusJitterMs = toFloat(value, versusJitterMs);
+    }
+    else if (name == "versus-loss")
+    {
+        versusLoss = toFloat(value, versusLoss);
+    }
+    else if (name == "versus-report")
+    {
+        versusReport = std::string(value);
+    }
+    else if (name == "autoplay")
+    {
+        autoplay = toBool(value);
+    }
+    else if (name == "quit-after")
+    {
+        quitAfter = toFloat(value, quitAfter);
+    }
+    else if (name == "inspector")
+    {
+        inspector = toBool(value);
+    }
+    else if (name == "zero-alloc-gate")
+    {
+        zeroAllocGateFrames = toUint(value, 1800);
+        // A collision would leave the gameplay loop for GameOver before steady state is reached
+        invulnerable = true;
+    }
+    else if (name == "stress")
+    {
+        stress       = toBool(value);
+        invulnerable = invulnerable || stress;
+    }
+    else if (name == "stress-budget-ms")
+    {
+        stressBudgetMs = toFloat(value, stressBudgetMs);
+    }
+    else if (name == "stress-step")
+    {
+        stressStep = toUint(value, stressStep);
+    }
+    else if (name == "stress-step-seconds")
+    {
+        stressStepSeconds = toFloat(value, stressStepSeconds);
+    }
+    else if (name == "stress-max-bombs")
+    {
+        stressMaxBombs = toUint(value, stressMaxBombs);
+    }
+    else if (name == "stress-report")
+    {
+        stressReport = std::string(value);
+    }
+    else if (name == "sim-rounds")
+    {
+        simRounds = toUint(value, simRounds);
+    }
+    else if (name == "sim-threads")
+    {
+        simThreads = toUint(value, simThreads);
+    }
+    else if (name == "sim-max-seconds")
+    {
+        simMaxSeconds = toFloat(value, simMaxSeconds);
+    }
+    else if (name == "sim-step")
+    {
+        simStep = toFloat(value, simStep);
+    }
+    else if (name == "sim-bot-skill")
+    {
+        simBotSkill = toFloat(value, simBotSkill);
+    }
+    else if (name == "sim-sweep")
+    {
+        simSweeps.emplace_back(value);
+    }
+    else if (name == "sim-report")
+    {
+        simReport = std::string(value);
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+@brief  Process-wide game options. Desktop builds read them from the command line.
+
+Every option can be given as `--name=value` on the command line or as a
+`name = value` line in a file passed with `--config=path` (`#` starts a comment).
+Later settings win, so command-line options after --config override the file.
+*/
+struct GameConfig
+{
+    // Gameplay
+    float spawnInterval = 8.0f;    // spawn-interval: seconds between bomb waves
+    uint32_t waveSize   = 3;       // wave-size: bombs per wave
+    float waveStagger   = 0.0f;    // wave-stagger: seconds between the bombs of a wave
+    float minSpeed      = 90.0f;   // min-speed: bomb fall speed range, points per second
+    float maxSpeed      = 180.0f;  // max-speed
+    float scoreInterval = 3.0f;    // score-interval: seconds between score ticks
+    int scorePerTick    = 10;      // score-per-tick
+    bool invulnerable   = false;   // invulnerable: bombs never end the round
+    uint64_t seed       = 0;       // seed: gameplay random seed, 0 picks one per launch
+
+    // Rendering
+    bool staticCache   = true;  // static-cache: draw static layers (backgrounds, titles) once into a cached texture
+    bool gpuBombMotion = true;  // gpu-bomb-motion: bombs fall in the vertex shader, uploaded only when they come or go
+
+    // Threading; ignored on single-core devices and WASM
+    bool threadedSim    = false;  // threaded-sim: step the round on its own thread, the main thread only draws it
+    float threadedSimHz = 60.0f;  // threaded-sim-hz: fixed simulation steps per second
+
+    // Frame telemetry
+    bool telemetry          = true;   // telemetry: per-scene frame, update and render time histograms
+    float telemetryInterval = 10.0f;  // telemetry-interval: seconds per exported window
+    float telemetryBudgetMs = 0.0f;   // telemetry-budget-ms: update or render time allowed, 0 uses the frame interval
+    std::string telemetryFile;        // telemetry-file: window log, default <writable path>/frame_telemetry.txt
+    std::string telemetryStatsd;      // telemetry-statsd=host:port: send windows as statsd gauges over UDP instead
+
+    // Online
+    std::string leaderboardUrl;  // leaderboard-url: endpoint scores are POSTed to, empty keeps them local
+
+    // Versus: two players kept in step by a rollback session; the second one is a bot peer in this process
+    bool versus                 = false;       // versus: play a versus match instead of the solo game
+    uint32_t versusFrames       = 0;           // versus-frames: headless, two bot peers play this many frames (desktop)
+    std::string versusTransport = "loopback";  // versus-transport: loopback, or udp through 127.0.0.1
+    uint32_t versusPort         = 7000;        // versus-port: udp, the peers bind this port and the next one
+    uint32_t versusDelay        = 2;           // versus-delay: input delay in frames
+    uint32_t versusRollback     = 8;           // versus-rollback: most frames predicted ahead of the peer
+    float versusLatencyMs       = 40.0f;       // versus-latency-ms: simulated one-way latency
+    float versusJitterMs        = 10.0f;       // versus-jitter-ms: simulated extra delay, up to this much
+    float versusLoss            = 0.02f;       // versus-loss: simulated packet loss, 0 to 1
+    std::string versusReport;                  // versus-report: report path, default <writable path>/versus_report.txt
+
+    // Unattended runs (profile training, soak tests)
+    bool autoplay   = false;  // autoplay: a scripted player taps bombs and dodges through the input queue
+    float quitAfter = 0.0f;   // quit-after: end the app after this many seconds, 0 runs forever
+
+    // Debug builds with the ImGui extension
+    bool inspector = true;  // inspector: the performance overlay, collapsed until tapped; F1 hides it
+
+    // Zero-allocation gate, needs -DHAPPY_ALLOC_TRACKING=ON; implies invulnerable
+    uint32_t zeroAllocGateFrames = 0;  // zero-alloc-gate[=N]: run N gameplay frames (default 1800)
+
+    // Stress mode; implies invulnerable and disables V-Sync
+    bool stress                = false;   // stress: ramp bomb count until the frame budget is exceeded
+    float stressBudgetMs       = 16.67f;  // stress-budget-ms: p95 frame work time allowed per step
+    uint32_t stressStep        = 50;      // stress-step: bombs added per step
+    float stressStepSeconds    = 2.0f;    // stress-step-seconds: how long each step is measured
+    uint32_t stressMaxBombs    = 20000;   // stress-max-bombs: stop ramping here even if within budget
+    std::string stressReport;             // stress-report: report path, default <writable path>/stress_report.txt
+
+    // Headless batch simulation (desktop); runs instead of the game when sim-rounds is set
+    uint32_t simRounds  = 0;             // sim-rounds: rounds played per parameter set
+    uint32_t simThreads = 0;             // sim-threads: worker threads, 0 uses every core
+    float simMaxSeconds = 600.0f;        // sim-max-seconds: rounds still alive this long count as survived
+    float simStep       = 1.0f / 60;     // sim-step: fixed step of the simulation, seconds
+    float simBotSkill   = 0.8f;          // sim-bot-skill: chance the bot acts on each decision, 0 leaves it idle
+    std::vector<std::string> simSweeps;  // sim-sweep=name:v1,v2,...: one set per value; repeat to combine
+    std::string simReport;               // sim-report: report path, default <writable path>/sim_report.txt
+
+    static GameConfig* getInstance();
+
+    /** Apply `--name[=value]` arguments. Unknown arguments are ignored. */
+    void parseCommandLine(int argc, char** argv);
+
+    /** Apply a `name = value` file. @return false if it cannot be read. */
+    bool loadFile(std::string_view path);
+
+    /** Apply one option. @return false for unknown names. */
+    bool set(std::string_view name, std::string_view value);
+};
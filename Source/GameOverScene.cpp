@@ -1,5 +1,7 @@
 #include "GameOverScene.h"
-#include "MainScene.h"
+#include "FramePacer.h"
+#include "GameConfig.h"
+#include "StaticLayer.h"
 
 ax::Scene* GameOver::createScene()
 {
@@ -14,6 +16,7 @@ bool GameOver::init()
     {
         return false;
     }
+    setName("GameOver");
 
     _director       = ax::Director::getInstance();
     _visibleSize    = _director->getVisibleSize();
@@ -28,33 +31,53 @@ bool GameOver::init()
     menu->setPosition(ax::Vec2::ZERO);
     this->addChild(menu, 1);
 
+    // Everything but the menu is drawn once and composited as a single opaque quad
+    auto staticLayer = StaticLayer::create();
+    staticLayer->setCacheEnabled(GameConfig::getInstance()->staticCache);
+    staticLayer->setOpaque(true);
+    this->addChild(staticLayer, -1);
+
     auto bg = ax::Sprite::create("background.png");
     bg->setAnchorPoint(ax::Vec2());
     bg->setPosition(0, 0);
-    this->addChild(bg, -1);
+    staticLayer->addChild(bg, -1);
 
     auto lblGameOver = ax::Label::createWithTTF("Game Over", "fonts/Marker Felt.ttf", 96);
     lblGameOver->enableOutline(ax::Color32(255, 0, 0, 100), 6);
     lblGameOver->enableGlow(ax::Color32(255, 0, 0, 255));
     lblGameOver->enableShadow();
     lblGameOver->setPosition(origin.x + _visibleSize.width / 2, origin.y + _visibleSize.height / 2);
-    this->addChild(lblGameOver, 1);
+    staticLayer->addChild(lblGameOver, 1);
 
     auto lblScoreText = ax::Label::createWithSystemFont("Your score is", "Arial", 48);
     lblScoreText->setPosition(origin.x + _visibleSize.width / 2, origin.y + _visibleSize.height / 2.5);
-    this->addChild(lblScoreText, 1);
+    staticLayer->addChild(lblScoreText, 1);
 
     char scoreText[32];
     int score = ax::UserDefault::getInstance()->getIntegerForKey("score", 0);
     sprintf(scoreText, "%d", score);
     auto lblScoreNumber = ax::Label::createWithBMFont("font.fnt", scoreText);
     lblScoreNumber->setPosition(origin.x + _visibleSize.width / 2, origin.y + _visibleSize.height / 3.5);
-    this->addChild(lblScoreNumber, 1);
+    staticLayer->addChild(lblScoreNumber, 1);
 
     return true;
 }
 
+// Static screen: let the pacer stop redrawing until the player taps Play
+void GameOver::onEnterTransitionDidFinish()
+{
+    Scene::onEnterTransitionDidFinish();
+    FramePacer::getInstance()->setSceneIdle(this, true);
+}
+
+void GameOver::onExit()
+{
+    FramePacer::getInstance()->setSceneIdle(this, false);
+    Scene::onExit();
+}
+
 void GameOver::exit(ax::Object* pSender)
 {
-    _director->replaceScene(ax::TransitionFlipX::create(0.0, MainScene::createScene()));
+    // MainScene is still underneath us and resets the round when it is entered again
+    _director->popScene();
 }
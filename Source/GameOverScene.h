@@ -9,6 +9,8 @@ public:
     ~GameOver() = default;
     static ax::Scene* createScene();
     bool init() override;
+    void onEnterTransitionDidFinish() override;
+    void onExit() override;
     void exit(ax::Object* pSender);
 
 private:
@@ -0,0 +1,454 @@
+#include "GameRound.h"
+#include "SystemTimings.h"
+
+#include <algorithm>
+
+// Orders the expiry heap so its front is the earliest
+static bool expiresLater(const BombExpiry& a, const BombExpiry& b)
+{
+    return a.at > b.at;
+}
+
+GameRules GameRules::fromConfig(const GameConfig& config)
+{
+    GameRules rules;
+    rules.spawnInterval = config.spawnInterval;
+    rules.waveSize      = config.waveSize;
+    rules.waveStagger   = config.waveStagger;
+    rules.minSpeed      = config.minSpeed;
+    rules.maxSpeed      = config.maxSpeed;
+    rules.scoreInterval = config.scoreInterval;
+    rules.scorePerTick  = config.scorePerTick;
+    rules.invulnerable  = config.invulnerable;
+    return rules;
+}
+
+void GameRound::setField(const ax::Size& field, const ax::Size& playerSize, const ax::Size& bombSize)
+{
+    _field      = field;
+    _playerSize = playerSize;
+    _bombSize   = bombSize;
+
+    // Both the hits and the exits depend on the sizes
+    solveHits();
+    rebuildExpiries();
+}
+
+void GameRound::reserve(size_t count)
+{
+    _bombs.reserve(count);
+    _freeBombs.reserve(count);
+    // Tapped bombs leave their expiry behind until it comes due
+    _bombExpiries.reserve(count * 2);
+    _bombChanges.reserve(count);
+}
+
+void GameRound::setTrackBombChanges(bool track)
+{
+    _trackBombChanges = track;
+    _bombChanges.clear();
+}
+
+void GameRound::clearBombs()
+{
+    _bombs.clear();
+    _freeBombs.clear();
+    _bombExpiries.clear();
+    _bombChanges.clear();
+    _liveBombs = 0;
+    _nextHitAt = NEVER;
+    ++_bombRevision;
+}
+
+void GameRound::reset(bool firstWave)
+{
+    clearBombs();
+    _playerPosition = ax::Vec2(_field.width / 2, _field.height * 0.23f);
+    _score          = 0;
+    _elapsed        = 0.0f;
+    _bombsTapped    = 0;
+    _over           = false;
+
+    // Every round starts at time zero, so two rounds from the same seed stay in step
+    _timeline.clear();
+    _timeline.setTime(0.0);
+    if (firstWave)
+    {
+        spawnWave();
+    }
+    startScripts(_timeline.now(), _timeline.now(), _rules.waveSize);
+}
+
+// Restarting the scripts forgets their waits, but every wait is an absolute time derived from these
+void GameRound::startScripts(double lastWaveAt, double lastScoreAt, uint32_t waveSpawned)
+{
+    _timeline.clear();
+    _lastWaveAt  = lastWaveAt;
+    _lastScoreAt = lastScoreAt;
+    _waveSpawned = waveSpawned;
+    _timeline.start(waves(_timeline));
+    _timeline.start(scoreTicks(_timeline));
+}
+
+Timeline::Task GameRound::waves(Timeline& timeline)
+{
+    if (_rules.spawnInterval <= 0.0f)
+    {
+        co_return;
+    }
+
+    // The rest of a staggered wave, if the scripts were restarted in the middle of one
+    co_await wave(timeline);
+    for (;;)
+    {
+        // The interval runs from the start of a wave, however long its stagger takes
+        co_await timeline.at(_lastWaveAt + _rules.spawnInterval);
+        _lastWaveAt  = timeline.now();
+        _waveSpawned = 0;
+        co_await wave(timeline);
+    }
+}
+
+Timeline::Task GameRound::wave(Timeline& timeline)
+{
+    while (_waveSpawned < _rules.waveSize)
+    {
+        co_await timeline.at(_lastWaveAt + double(_rules.waveStagger) * _waveSpawned);
+        spawnBomb(ax::Vec2(_rng.next01() * _field.width, _field.height));
+        ++_waveSpawned;
+    }
+}
+
+Timeline::Task GameRound::scoreTicks(Timeline& timeline)
+{
+    if (_rules.scoreInterval <= 0.0f)
+    {
+        co_return;
+    }
+
+    for (;;)
+    {
+        co_await timeline.at(_lastScoreAt + _rules.scoreInterval);
+        _score += _rules.scorePerTick;
+        _lastScoreAt = timeline.now();
+    }
+}
+
+bool GameRound::step(float dt)
+{
+    if (_over)
+    {
+        return false;
+    }
+    _elapsed += dt;
+    {
+        PERF_SCOPE(SystemTimings::System::Spawn);
+        _timeline.advance(dt);
+    }
+
+    // Every hit was solved when its bomb spawned or the player last moved, so only the earliest is checked
+    PERF_SCOPE(SystemTimings::System::Collision);
+    double now = _timeline.now();
+    if (_nextHitAt <= now)
+    {
+        _over = true;
+        return false;
+    }
+
+    while (!_bombExpiries.empty() && _bombExpiries.front().at < now)
+    {
+        std::pop_heap(_bombExpiries.begin(), _bombExpiries.end(), expiresLater);
+        BombExpiry expiry = _bombExpiries.back();
+        _bombExpiries.pop_back();
+        if (_bombs[expiry.slot].generation == expiry.generation)
+        {
+            releaseBomb(expiry.slot);
+        }
+    }
+    return true;
+}
+
+void GameRound::spawnBomb(const ax::Vec2& position)
+{
+    addBomb(ax::Vec2(position.x, position.y + _bombSize.height / 2), _rng.range(_rules.minSpeed, _rules.maxSpeed));
+}
+
+void GameRound::spawnWave()
+{
+    for (uint32_t i = 0; i < _rules.waveSize; i++)
+    {
+        spawnBomb(ax::Vec2(_rng.next01() * _field.width, _field.height));
+    }
+}
+
+// A new bomb takes the most recently freed slot, or a new one at the end
+void GameRound::addBomb(const ax::Vec2& center, float speed)
+{
+    uint32_t slot;
+    if (_freeBombs.empty())
+    {
+        slot = static_cast<uint32_t>(_bombs.size());
+        _bombs.push_back(Bomb{});
+    }
+    else
+    {
+        slot = _freeBombs.back();
+        _freeBombs.pop_back();
+    }
+
+    Bomb& bomb         = _bombs[slot];
+    bomb.spawnPosition = center;
+    bomb.speed         = speed;
+    bomb.spawnedAt     = _timeline.now();
+    bomb.alive         = true;
+    bomb.hitsAt        = solveHit(bomb);
+    _nextHitAt         = std::min(_nextHitAt, bomb.hitsAt);
+    ++_liveBombs;
+    pushExpiry(slot);
+    noteBombChange(slot);
+}
+
+void GameRound::releaseBomb(size_t slot)
+{
+    Bomb& bomb = _bombs[slot];
+    bomb.alive = false;
+    ++bomb.generation;
+    _freeBombs.push_back(static_cast<uint32_t>(slot));
+    --_liveBombs;
+    if (bomb.hitsAt != NEVER && bomb.hitsAt == _nextHitAt)
+    {
+        findNextHit();
+    }
+    noteBombChange(slot);
+}
+
+// A consumer that falls behind gets one full rewrite instead of an ever longer list
+void GameRound::noteBombChange(size_t slot)
+{
+    if (!_trackBombChanges)
+    {
+        return;
+    }
+    if (_bombChanges.size() >= std::max<size_t>(_bombs.size(), 1))
+    {
+        _bombChanges.clear();
+        ++_bombRevision;
+        return;
+    }
+    _bombChanges.push_back(static_cast<uint32_t>(slot));
+}
+
+// The player only moves sideways and a bomb only falls, so the hit is the span where the columns overlap and
+// the bomb's bottom is at or below the player's top while its top is at or above the player's bottom. Bounds
+// are inclusive, like ax::Rect::intersectsRect().
+double GameRound::solveHit(const Bomb& bomb) const
+{
+    if (_rules.invulnerable)
+    {
+        return NEVER;
+    }
+
+    ax::Rect player = getPlayerBox();
+    float halfWidth = _bombSize.width / 2;
+    if (bomb.spawnPosition.x + halfWidth < player.getMinX() || bomb.spawnPosition.x - halfWidth > player.getMaxX())
+    {
+        return NEVER;
+    }
+
+    double now       = _timeline.now();
+    float halfHeight = _bombSize.height / 2;
+    float toTouch    = bomb.spawnPosition.y - halfHeight - player.getMaxY();
+    float toPass     = bomb.spawnPosition.y + halfHeight - player.getMinY();
+    if (bomb.speed <= 0.0f)
+    {
+        return toTouch <= 0.0f && toPass >= 0.0f ? now : NEVER;
+    }
+
+    double touchAt = bomb.spawnedAt + toTouch / bomb.speed;
+    double passAt  = bomb.spawnedAt + toPass / bomb.speed;
+    return passAt < now ? NEVER : std::max(touchAt, now);
+}
+
+void GameRound::solveHits()
+{
+    for (Bomb& bomb : _bombs)
+    {
+        if (bomb.alive)
+        {
+            bomb.hitsAt = solveHit(bomb);
+        }
+    }
+    findNextHit();
+}
+
+void GameRound::findNextHit()
+{
+    _nextHitAt = NEVER;
+    for (const Bomb& bomb : _bombs)
+    {
+        if (bomb.alive)
+        {
+            _nextHitAt = std::min(_nextHitAt, bomb.hitsAt);
+        }
+    }
+}
+
+// A bomb is out of the field once its top edge is below the bottom; one that does not fall never leaves
+void GameRound::pushExpiry(size_t slot)
+{
+    const Bomb& bomb = _bombs[slot];
+    if (bomb.speed <= 0.0f)
+    {
+        return;
+    }
+
+    double exitAt = bomb.spawnedAt + (bomb.spawnPosition.y + _bombSize.height / 2) / bomb.speed;
+    _bombExpiries.push_back(BombExpiry{exitAt, static_cast<uint32_t>(slot), bomb.generation});
+    std::push_heap(_bombExpiries.begin(), _bombExpiries.end(), expiresLater);
+}
+
+void GameRound::rebuildExpiries()
+{
+    _bombExpiries.clear();
+    for (size_t slot = 0; slot < _bombs.size(); ++slot)
+    {
+        if (_bombs[slot].alive)
+        {
+            pushExpiry(slot);
+        }
+    }
+}
+
+void GameRound::movePlayerTo(float x)
+{
+    float halfWidth = _playerSize.width / 2;
+    if (x >= halfWidth && x < _field.width - halfWidth && x != _playerPosition.x)
+    {
+        _playerPosition.x = x;
+        solveHits();
+    }
+}
+
+void GameRound::dragPlayer(const ax::Vec2& touch)
+{
+    if (getPlayerBox().containsPoint(touch))
+    {
+        movePlayerTo(touch.x);
+    }
+}
+
+ax::Rect GameRound::getPlayerBox() const
+{
+    return ax::Rect(_playerPosition.x - _playerSize.width / 2, _playerPosition.y - _playerSize.height / 2,
+                    _playerSize.width, _playerSize.height);
+}
+
+ax::Rect GameRound::getBombBox(size_t slot) const
+{
+    ax::Vec2 position = getBombPosition(slot);
+    return ax::Rect(position.x - _bombSize.width / 2, position.y - _bombSize.height / 2, _bombSize.width,
+                    _bombSize.height);
+}
+
+GameRound::BotMove GameRound::suggestBotMove() const
+{
+    BotMove move;
+    if (_over || _liveBombs == 0)
+    {
+        return move;
+    }
+
+    ax::Vec2 lowest(0.0f, std::numeric_limits<float>::infinity());
+    forEachBomb([&lowest](const ax::Vec2& position, float) {
+        if (position.y < lowest.y)
+        {
+            lowest = position;
+        }
+    });
+
+    move.tap   = lowest.y < _field.height;
+    move.tapAt = lowest;
+
+    // Drags only move the player while they stay inside it, so step by less than half its width
+    float direction = lowest.x < _playerPosition.x ? 1.0f : -1.0f;
+    move.drag       = true;
+    move.dragTo     = ax::Vec2(_playerPosition.x + direction * _playerSize.width * 0.4f, _playerPosition.y);
+    return move;
+}
+
+void GameRound::save(GameSnapshot& snapshot) const
+{
+    snapshot.visibleSize = _field;
+    snapshot.score       = _score;
+    snapshot.playerX     = _playerPosition.x;
+    snapshot.spawnTimer  = static_cast<float>(_timeline.now() - _lastWaveAt);
+    snapshot.scoreTimer  = static_cast<float>(_timeline.now() - _lastScoreAt);
+    snapshot.rngState    = _rng.getState();
+    snapshot.bombs.clear();
+    forEachBomb([&snapshot](const ax::Vec2& position, float speed) {
+        snapshot.bombs.push_back(GameSnapshot::Bomb{position.x, position.y, speed});
+    });
+}
+
+void GameRound::restore(const GameSnapshot& snapshot)
+{
+    float scaleX = _field.width / snapshot.visibleSize.width;
+    float scaleY = _field.height / snapshot.visibleSize.height;
+
+    // The player moves first, so every bomb's hit is solved against where it ends up
+    clearBombs();
+    _score = snapshot.score;
+    _over  = false;
+    _rng.setState(snapshot.rngState);
+    movePlayerTo(snapshot.playerX * scaleX);
+
+    // The saved bombs spawn again where they were, now
+    for (const auto& bomb : snapshot.bombs)
+    {
+        addBomb(ax::Vec2(bomb.x * scaleX, bomb.y * scaleY), bomb.speed);
+    }
+    _bombChanges.clear();
+
+    // A staggered wave cut off by the snapshot counts as complete
+    startScripts(_timeline.now() - snapshot.spawnTimer, _timeline.now() - snapshot.scoreTimer, _rules.waveSize);
+}
+
+void GameRound::saveState(RoundState& state) const
+{
+    state.bombs.assign(_bombs.begin(), _bombs.end());
+    state.freeBombs.assign(_freeBombs.begin(), _freeBombs.end());
+    state.bombExpiries.assign(_bombExpiries.begin(), _bombExpiries.end());
+    state.liveBombs      = _liveBombs;
+    state.nextHitAt      = _nextHitAt;
+    state.playerPosition = _playerPosition;
+    state.rngState       = _rng.getState();
+    state.time           = _timeline.now();
+    state.lastWaveAt     = _lastWaveAt;
+    state.lastScoreAt    = _lastScoreAt;
+    state.waveSpawned    = _waveSpawned;
+    state.score          = _score;
+    state.elapsed        = _elapsed;
+    state.bombsTapped    = _bombsTapped;
+    state.over           = _over;
+}
+
+void GameRound::restoreState(const RoundState& state)
+{
+    _bombs.assign(state.bombs.begin(), state.bombs.end());
+    _freeBombs.assign(state.freeBombs.begin(), state.freeBombs.end());
+    _bombExpiries.assign(state.bombExpiries.begin(), state.bombExpiries.end());
+    _liveBombs = state.liveBombs;
+    _nextHitAt = state.nextHitAt;
+    _bombChanges.clear();
+    ++_bombRevision;
+    _playerPosition = state.playerPosition;
+    _rng.setState(state.rngState);
+    _score       = state.score;
+    _elapsed     = state.elapsed;
+    _bombsTapped = state.bombsTapped;
+    _over        = state.over;
+
+    _timeline.clear();
+    _timeline.setTime(state.time);
+    startScripts(state.lastWaveAt, state.lastScoreAt, state.waveSpawned);
+}
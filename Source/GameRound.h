@@ -0,0 +1,263 @@
+#pragma once
+
+#include "axmol/axmol.h"
+#include "GameConfig.h"
+#include "GameSnapshot.h"
+#include "Rng.h"
+#include "Timeline.h"
+
+#include <limits>
+#include <vector>
+
+/** The gameplay options a round is played with; a copy, so batch runs can vary them per round. */
+struct GameRules
+{
+    float spawnInterval = 8.0f;
+    uint32_t waveSize   = 3;
+    float waveStagger   = 0.0f;
+    float minSpeed      = 90.0f;
+    float maxSpeed      = 180.0f;
+    float scoreInterval = 3.0f;
+    int scorePerTick    = 10;
+    bool invulnerable   = false;
+
+    static GameRules fromConfig(const GameConfig& config);
+};
+
+/**
+@brief  One bomb as it spawned. Bombs fall straight down at a constant speed, so
+        where one is now follows from the round's time; nothing moves them.
+*/
+struct Bomb
+{
+    ax::Vec2 spawnPosition;  // center at spawnedAt
+    float speed;             // points per second
+    double spawnedAt;        // timeline time
+    double hitsAt;           // timeline time it reaches the player where the player is now, or GameRound::NEVER
+    uint32_t generation;     // bumped when the slot is released, so its old expiry is skipped
+    bool alive;
+
+    ax::Vec2 positionAt(double time) const
+    {
+        return ax::Vec2(spawnPosition.x, spawnPosition.y - speed * static_cast<float>(time - spawnedAt));
+    }
+};
+
+/** When a bomb slot falls out of the field; kept as a min-heap. */
+struct BombExpiry
+{
+    double at;
+    uint32_t slot;
+    uint32_t generation;
+};
+
+/**
+@brief  The exact state of a round, for rollback.
+
+Unlike GameSnapshot it keeps the timeline's clock and the scripts' deadlines as
+they are, so a round restored from it steps on bit for bit like the original.
+Its vectors keep their capacity, so saving into the same state again does not
+allocate.
+*/
+struct RoundState
+{
+    std::vector<Bomb> bombs;
+    std::vector<uint32_t> freeBombs;
+    std::vector<BombExpiry> bombExpiries;
+    size_t liveBombs = 0;
+    double nextHitAt = 0.0;
+    ax::Vec2 playerPosition;
+    uint64_t rngState    = 0;
+    double time          = 0.0;  // timeline time
+    double lastWaveAt    = 0.0;
+    double lastScoreAt   = 0.0;
+    uint32_t waveSpawned = 0;
+    int score            = 0;
+    float elapsed        = 0.0f;
+    uint32_t bombsTapped = 0;
+    bool over            = false;
+};
+
+/**
+@brief  The rules of one round, without any nodes: spawning, bomb motion, collision, taps and score.
+
+MainScene plays a GameRound and mirrors it into its sprites each frame; the
+batch simulator plays thousands of them headless. Everything is in points, in a
+field whose origin is the bottom-left corner. All randomness comes from the
+round's own Rng, so a round replays exactly from its seed.
+
+Waves and score ticks are scripts on the round's own Timeline, advanced by
+step() before the bombs are checked.
+
+A bomb is stored as it spawned and never moved: its position is computed when
+asked for. When it will hit the player is solved once, at spawn and again
+whenever the player moves, so step() only compares the clock against the
+earliest hit and pops the bombs that left the field off a heap. A bomb keeps
+its slot for life; a released slot is marked dead and reused by the next spawn.
+*/
+class GameRound
+{
+public:
+    /** Bomb::hitsAt of a bomb that misses the player. */
+    static constexpr double NEVER = std::numeric_limits<double>::infinity();
+
+    /** What a simple bot would do now: tap the lowest bomb and step away from it. */
+    struct BotMove
+    {
+        bool tap = false;
+        ax::Vec2 tapAt;
+        bool drag = false;
+        ax::Vec2 dragTo;
+    };
+
+    void setRules(const GameRules& rules) { _rules = rules; }
+    const GameRules& getRules() const { return _rules; }
+
+    /** Field and sprite sizes in points. Call before reset(). */
+    void setField(const ax::Size& field, const ax::Size& playerSize, const ax::Size& bombSize);
+
+    void setSeed(uint64_t seed) { _rng.setState(seed); }
+    Rng& getRng() { return _rng; }
+    const Rng& getRng() const { return _rng; }
+
+    /** Start over: no bombs, no score, the player centered. The first wave spawns right away if asked. */
+    void reset(bool firstWave = true);
+
+    /**
+    @brief  Advance by `dt` seconds: score ticks, waves, then the earliest hit and the bombs that left.
+    @return false once a bomb hit the player. The round stays over until reset().
+    */
+    bool step(float dt);
+
+    bool isOver() const { return _over; }
+    float getElapsed() const { return _elapsed; }
+    int getScore() const { return _score; }
+
+    /** The clock bombs fall by: timeline time, zero at reset(). */
+    double getTime() const { return _timeline.now(); }
+
+    /** Spawn a bomb whose bottom edge is at `position`, with a random speed. */
+    void spawnBomb(const ax::Vec2& position);
+    void spawnWave();
+
+    /** Grow bomb storage up front so spawning up to `count` bombs does not allocate. */
+    void reserve(size_t count);
+
+    /** Explode every bomb under `point`, calling `onExplode(position)` for each. @return how many. */
+    template <typename Callback>
+    size_t tap(const ax::Vec2& point, Callback&& onExplode)
+    {
+        size_t exploded = 0;
+        for (size_t i = 0; i < _bombs.size(); ++i)
+        {
+            if (_bombs[i].alive && getBombBox(i).containsPoint(point))
+            {
+                onExplode(getBombPosition(i));
+                releaseBomb(i);
+                ++exploded;
+            }
+        }
+        _bombsTapped += static_cast<uint32_t>(exploded);
+        return exploded;
+    }
+    size_t tap(const ax::Vec2& point) { return tap(point, [](const ax::Vec2&) {}); }
+
+    /** Move the player to `x` unless that puts part of it outside the field. */
+    void movePlayerTo(float x);
+
+    /** A drag moves the player only while it stays inside the player. */
+    void dragPlayer(const ax::Vec2& touch);
+
+    void tiltPlayer(float accelerationX) { movePlayerTo(_playerPosition.x + accelerationX * 10); }
+
+    const ax::Vec2& getPlayerPosition() const { return _playerPosition; }
+    ax::Rect getPlayerBox() const;
+
+    /** Live bombs; getBombSlotCount() also counts the dead slots between them. */
+    size_t getBombCount() const { return _liveBombs; }
+    size_t getBombSlotCount() const { return _bombs.size(); }
+    const Bomb& getBomb(size_t slot) const { return _bombs[slot]; }
+    ax::Vec2 getBombPosition(size_t slot) const { return _bombs[slot].positionAt(_timeline.now()); }
+    ax::Rect getBombBox(size_t slot) const;
+    uint32_t getBombsTapped() const { return _bombsTapped; }
+
+    /** Call `callback(position, speed)` for every live bomb, in slot order. */
+    template <typename Callback>
+    void forEachBomb(Callback&& callback) const
+    {
+        for (const Bomb& bomb : _bombs)
+        {
+            if (bomb.alive)
+            {
+                callback(bomb.positionAt(_timeline.now()), bomb.speed);
+            }
+        }
+    }
+
+    /** Changes when every slot may have changed: reset, restore, or more changes than takeBombChanges() kept. */
+    uint32_t getBombRevision() const { return _bombRevision; }
+
+    /** Keep the slots that spawned or released a bomb, for takeBombChanges(). Off by default. */
+    void setTrackBombChanges(bool track);
+
+    /** Call `onChanged(slot)` for every slot changed since the last call, within the same revision. */
+    template <typename Callback>
+    void takeBombChanges(Callback&& onChanged)
+    {
+        for (uint32_t slot : _bombChanges)
+        {
+            onChanged(slot);
+        }
+        _bombChanges.clear();
+    }
+
+    BotMove suggestBotMove() const;
+
+    /** Copy the round into `snapshot`; the field size goes with it. */
+    void save(GameSnapshot& snapshot) const;
+
+    /** Continue a saved round, rescaled if the field changed size since. */
+    void restore(const GameSnapshot& snapshot);
+
+    /** Copy the exact state, for rollback. Rules, field and sizes are not part of it. */
+    void saveState(RoundState& state) const;
+    void restoreState(const RoundState& state);
+
+private:
+    void clearBombs();
+    void addBomb(const ax::Vec2& center, float speed);
+    void releaseBomb(size_t slot);
+    void noteBombChange(size_t slot);
+    double solveHit(const Bomb& bomb) const;
+    void solveHits();
+    void findNextHit();
+    void pushExpiry(size_t slot);
+    void rebuildExpiries();
+    void startScripts(double lastWaveAt, double lastScoreAt, uint32_t waveSpawned);
+    Timeline::Task waves(Timeline& timeline);
+    Timeline::Task wave(Timeline& timeline);
+    Timeline::Task scoreTicks(Timeline& timeline);
+
+    GameRules _rules;
+    Rng _rng;
+    ax::Size _field;
+    ax::Size _playerSize;
+    ax::Size _bombSize;
+    ax::Vec2 _playerPosition;
+    std::vector<Bomb> _bombs;
+    std::vector<uint32_t> _freeBombs;       // dead slots, reused last in first out
+    std::vector<BombExpiry> _bombExpiries;  // min-heap by time; released bombs leave stale entries
+    std::vector<uint32_t> _bombChanges;     // slots changed since takeBombChanges(), while tracked
+    Timeline _timeline;
+    size_t _liveBombs      = 0;
+    double _nextHitAt      = NEVER;  // earliest Bomb::hitsAt
+    bool _trackBombChanges = false;
+    int _score             = 0;
+    double _lastScoreAt    = 0.0;  // timeline time of the last score tick
+    double _lastWaveAt     = 0.0;  // timeline time of the last wave
+    uint32_t _waveSpawned  = 0;    // bombs of the last wave out so far
+    float _elapsed         = 0.0f;
+    uint32_t _bombsTapped  = 0;
+    uint32_t _bombRevision = 0;
+    bool _over             = false;
+};
@@ -0,0 +1,119 @@
+#include "GameSnapshot.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+struct SnapshotHeader
+{
+    char magic[4];  // "HSNP"
+    uint32_t version;
+    float visibleWidth, visibleHeight;
+    int32_t score;
+    float playerX;
+    float spawnTimer;
+    float scoreTimer;
+    uint64_t rngState;
+    uint32_t bombCount;
+    uint32_t checksum;  // FNV-1a of the bomb records
+};
+static_assert(sizeof(SnapshotHeader) == 48, "SnapshotHeader is a file format");
+
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+uint32_t checksumOf(const uint8_t* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+std::string snapshotPath()
+{
+    return ax::FileUtils::getInstance()->getWritablePath() + "round.snap";
+}
+}  // namespace
+
+bool GameSnapshot::save(std::vector<uint8_t>& buffer) const
+{
+    const size_t bombBytes = bombs.size() * sizeof(Bomb);
+    buffer.resize(sizeof(SnapshotHeader) + bombBytes);
+
+    SnapshotHeader header;
+    memcpy(header.magic, "HSNP", 4);
+    header.version       = SNAPSHOT_VERSION;
+    header.visibleWidth  = visibleSize.width;
+    header.visibleHeight = visibleSize.height;
+    header.score         = score;
+    header.playerX       = playerX;
+    header.spawnTimer    = spawnTimer;
+    header.scoreTimer    = scoreTimer;
+    header.rngState      = rngState;
+    header.bombCount     = static_cast<uint32_t>(bombs.size());
+    header.checksum      = checksumOf(reinterpret_cast<const uint8_t*>(bombs.data()), bombBytes);
+    memcpy(buffer.data(), &header, sizeof(header));
+    if (bombBytes > 0)
+    {
+        memcpy(buffer.data() + sizeof(header), bombs.data(), bombBytes);
+    }
+
+    // One write and a rename; no FileUtils round trip through ax::Data
+    std::string path      = snapshotPath();
+    std::string writePath = path + ".tmp";
+    FILE* file            = fopen(writePath.c_str(), "wb");
+    if (!file)
+    {
+        return false;
+    }
+    bool written = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    written      = fclose(file) == 0 && written;
+    // Not std::rename, which fails on Windows once a snapshot exists; FileUtils replaces it on every platform
+    if (!written || !ax::FileUtils::getInstance()->renameFile(writePath, path))
+    {
+        AXLOGW("Cannot write the round snapshot to {}", path);
+        return false;
+    }
+    return true;
+}
+
+bool GameSnapshot::load()
+{
+    ax::Data data = ax::FileUtils::getInstance()->getDataFromFile(snapshotPath());
+    if (data.getSize() < sizeof(SnapshotHeader))
+    {
+        return false;
+    }
+
+    SnapshotHeader header;
+    memcpy(&header, data.getBytes(), sizeof(header));
+    const uint8_t* records = data.getBytes() + sizeof(header);
+    size_t bombBytes       = size_t(header.bombCount) * sizeof(Bomb);
+    if (memcmp(header.magic, "HSNP", 4) != 0 || header.version != SNAPSHOT_VERSION ||
+        data.getSize() != sizeof(header) + bombBytes || checksumOf(records, bombBytes) != header.checksum)
+    {
+        AXLOGW("Ignoring malformed round snapshot");
+        return false;
+    }
+
+    visibleSize = ax::Size(header.visibleWidth, header.visibleHeight);
+    score       = header.score;
+    playerX     = header.playerX;
+    spawnTimer  = header.spawnTimer;
+    scoreTimer  = header.scoreTimer;
+    rngState    = header.rngState;
+    bombs.resize(header.bombCount);
+    if (bombBytes > 0)
+    {
+        memcpy(bombs.data(), records, bombBytes);
+    }
+    return true;
+}
+
+void GameSnapshot::discard()
+{
+    ax::FileUtils::getInstance()->removeFile(snapshotPath());
+}
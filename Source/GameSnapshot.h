@@ -0,0 +1,39 @@
+#pragma once
+
+#include "axmol/axmol.h"
+
+#include <vector>
+
+/**
+@brief  Everything needed to rebuild a live round, in a compact binary file.
+
+MainScene fills it when the app goes to the background, so a round survives the
+OS killing us there, and rebuilds the round from it on the next launch. The
+file is written to a temporary name and renamed, so a kill mid-write leaves the
+previous snapshot or none, never a torn one.
+*/
+struct GameSnapshot
+{
+    struct Bomb
+    {
+        float x, y;
+        float speed;
+    };
+
+    ax::Size visibleSize;  // positions are rescaled if the window changed size
+    int32_t score;
+    float playerX;
+    float spawnTimer;  // seconds since the last wave
+    float scoreTimer;  // seconds since the last score tick
+    uint64_t rngState;
+    std::vector<Bomb> bombs;
+
+    /** Serialize into `buffer` (kept by the caller to reuse its capacity) and write it out. */
+    bool save(std::vector<uint8_t>& buffer) const;
+
+    /** @return false if there is no snapshot or it is malformed. */
+    bool load();
+
+    /** Delete the snapshot, e.g. once it was restored or the app came back by itself. */
+    static void discard();
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+/**
+@brief  Fixed-size log-linear histogram of durations in microseconds, in the style of HdrHistogram.
+
+Values below 256 us get a bucket each. Above that, every power-of-two range is
+split into 128 buckets, so a percentile is within 1% of the recorded value from
+a microsecond up to MAX_US. Longer samples are counted at MAX_US, but max() is
+kept exactly. Recording is a few integer operations and never allocates.
+*/
+class HdrHistogram
+{
+public:
+    static constexpr uint64_t MAX_US = (1ull << 22) - 1;  // about 4.2 s
+
+    void record(uint64_t us)
+    {
+        ++_buckets[indexOf(std::min(us, MAX_US))];
+        ++_count;
+        _max = std::max(_max, us);
+    }
+
+    /** Add every sample of `other`, e.g. to fold a reporting window into a session total. */
+    void add(const HdrHistogram& other)
+    {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            _buckets[i] += other._buckets[i];
+        }
+        _count += other._count;
+        _max = std::max(_max, other._max);
+    }
+
+    /** Value at percentile `p` in [0, 1], in microseconds. Returns 0 without samples. */
+    uint64_t percentile(float p) const
+    {
+        if (_count == 0)
+        {
+            return 0;
+        }
+
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p * _count + 0.5f));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            seen += _buckets[i];
+            if (seen >= rank)
+            {
+                // The bucket's upper edge, but never more than the slowest sample
+                return std::min(highestOf(i), _max);
+            }
+        }
+        return _max;
+    }
+
+    /** How many samples were longer than `us`, to within a bucket. */
+    uint64_t countAbove(uint64_t us) const
+    {
+        uint64_t above = 0;
+        for (size_t i = indexOf(std::min(us, MAX_US)) + 1; i < BUCKET_COUNT; ++i)
+        {
+            above += _buckets[i];
+        }
+        return above;
+    }
+
+    uint64_t count() const { return _count; }
+    uint64_t max() const { return _max; }
+
+    void reset()
+    {
+        _buckets.fill(0);
+        _count = 0;
+        _max   = 0;
+    }
+
+private:
+    static constexpr int SUB_BUCKET_BITS   = 8;
+    static constexpr uint64_t SUB_BUCKETS  = 1ull << SUB_BUCKET_BITS;
+    static constexpr uint64_t HALF_BUCKETS = SUB_BUCKETS / 2;
+    static constexpr size_t BUCKET_COUNT   = (22 - SUB_BUCKET_BITS + 1) * HALF_BUCKETS + HALF_BUCKETS;
+
+    static size_t indexOf(uint64_t us)
+    {
+        if (us < SUB_BUCKETS)
+        {
+            return static_cast<size_t>(us);
+        }
+
+        int shift = -SUB_BUCKET_BITS + 1;
+        for (uint64_t v = us; v > 1; v >>= 1)
+        {
+            ++shift;
+        }
+        return static_cast<size_t>(shift * HALF_BUCKETS + (us >> shift));
+    }
+
+    static uint64_t highestOf(size_t index)
+    {
+        if (index < SUB_BUCKETS)
+        {
+            return index;
+        }
+
+        uint64_t shift = index / HALF_BUCKETS - 1;
+        uint64_t sub   = index - shift * HALF_BUCKETS;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::array<uint32_t, BUCKET_COUNT> _buckets{};
+    uint64_t _count = 0;
+    uint64_t _max   = 0;
+};
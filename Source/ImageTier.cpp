@@ -0,0 +1,268 @@
+#include "ImageTier.h"
+#include "FramePacer.h"
+#include "SpriteBatchRenderer.h"
+#include "StaticLayer.h"
+
+#include <algorithm>
+
+namespace
+{
+// Height the art of each tier was drawn for
+constexpr float TIER_HEIGHTS[] = {320.0f, 800.0f, 1280.0f};
+
+ImageTier* s_sharedImageTier = nullptr;
+
+std::string fileName(const std::string& path)
+{
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+}  // namespace
+
+ImageTier* ImageTier::getInstance()
+{
+    if (!s_sharedImageTier)
+    {
+        s_sharedImageTier = new ImageTier();
+    }
+    return s_sharedImageTier;
+}
+
+void ImageTier::destroyInstance()
+{
+    if (s_sharedImageTier)
+    {
+        ax::Director::getInstance()->getScheduler()->unscheduleAllForTarget(s_sharedImageTier);
+    }
+    delete s_sharedImageTier;
+    s_sharedImageTier = nullptr;
+}
+
+const char* ImageTier::getDirectory(Tier tier)
+{
+    switch (tier)
+    {
+    case Tier::Low:
+        return "images/low";
+    case Tier::Mid:
+        return "images/mid";
+    default:
+        return "images/high";
+    }
+}
+
+float ImageTier::getContentScale(Tier tier) const
+{
+    return TIER_HEIGHTS[static_cast<int>(tier)] / _designHeight;
+}
+
+void ImageTier::init(float frameHeight, float designHeight, std::vector<std::string>& searchPaths)
+{
+    _designHeight = designHeight;
+    if (frameHeight > 800)
+    {
+        _preferred = Tier::High;
+    }
+    else if (frameHeight > 600)
+    {
+        _preferred = Tier::Mid;
+    }
+    else
+    {
+        _preferred = Tier::Low;
+    }
+    _active = _target = _preferred;
+
+    searchPaths.push_back(getDirectory(_active));
+    ax::Director::getInstance()->setContentScaleFactor(getContentScale(_active));
+}
+
+void ImageTier::requestTier(Tier tier)
+{
+    if (isSwitching())
+    {
+        _queued    = tier;
+        _hasQueued = true;
+        return;
+    }
+    if (tier == _active)
+    {
+        return;
+    }
+
+    auto fileUtils = ax::FileUtils::getInstance();
+    _incoming.clear();
+    for (const auto& path : fileUtils->listFiles(fileUtils->fullPathForDirectory(getDirectory(tier))))
+    {
+        if (path.size() > 4 && path.compare(path.size() - 4, 4, ".png") == 0)
+        {
+            _incoming.push_back(path);
+        }
+    }
+    if (_incoming.empty())
+    {
+        AXLOGW("ImageTier: no images in {}", getDirectory(tier));
+        return;
+    }
+
+    AXLOGI("ImageTier: loading {} for {} -> {}", _incoming.size(), getDirectory(_active), getDirectory(tier));
+    // Async loads call back through the scheduler, which stops while the pacer sleeps
+    FramePacer::getInstance()->setBusy(this, true);
+    _target             = tier;
+    _pendingLoads       = static_cast<uint32_t>(_incoming.size());
+    uint32_t generation = ++_generation;
+    auto textureCache   = ax::Director::getInstance()->getTextureCache();
+    for (const auto& path : _incoming)
+    {
+        // Already cached textures call back right away; the swap still waits for the next tick
+        textureCache->addImageAsync(path, [this, generation](ax::Texture2D*) { onTextureLoaded(generation); });
+    }
+}
+
+void ImageTier::onTextureLoaded(uint32_t generation)
+{
+    if (generation != _generation || _pendingLoads == 0 || --_pendingLoads > 0)
+    {
+        return;
+    }
+
+    _swapScheduled = true;
+    ax::Director::getInstance()->getScheduler()->schedule([this](float dt) { trySwap(dt); }, this, 0.0f, false,
+                                                          "ImageTier.swap");
+}
+
+// Nodes inside a transition belong to two scenes at once; let it finish first
+void ImageTier::trySwap(float)
+{
+    if (dynamic_cast<ax::TransitionScene*>(ax::Director::getInstance()->getRunningScene()))
+    {
+        return;
+    }
+
+    ax::Director::getInstance()->getScheduler()->unschedule("ImageTier.swap", this);
+    _swapScheduled = false;
+    swap();
+
+    if (_hasQueued)
+    {
+        _hasQueued = false;
+        requestTier(_queued);
+    }
+    FramePacer::getInstance()->setBusy(this, isSwitching());
+}
+
+void ImageTier::swap()
+{
+    auto director     = ax::Director::getInstance();
+    auto fileUtils    = ax::FileUtils::getInstance();
+    auto textureCache = director->getTextureCache();
+
+    std::string oldDirectory = fileUtils->fullPathForDirectory(getDirectory(_active));
+    for (const auto& path : _incoming)
+    {
+        if (auto texture = textureCache->getTextureForKey(path))
+        {
+            _replacements[oldDirectory + fileName(path)] = texture;
+        }
+    }
+
+    auto searchPaths = fileUtils->getOriginalSearchPaths();
+    std::replace(searchPaths.begin(), searchPaths.end(), std::string(getDirectory(_active)),
+                 std::string(getDirectory(_target)));
+    fileUtils->setSearchPaths(searchPaths);
+    director->setContentScaleFactor(getContentScale(_target));
+
+    // BMFont atlases are cached by file name, which is the same in every tier
+    ax::FontAtlasCache::purgeCachedData();
+
+    AXLOGI("ImageTier: {} -> {}", getDirectory(_active), getDirectory(_target));
+    _active = _target;
+    if (auto scene = director->getRunningScene())
+    {
+        remap(scene);
+    }
+    director->getEventDispatcher()->dispatchCustomEvent(EVENT_TIER_CHANGED);
+
+    // Nothing refers to the old tier any more except the cache itself
+    for (const auto& replacement : _replacements)
+    {
+        textureCache->removeTextureForKey(replacement.first);
+    }
+    _replacements.clear();
+    _incoming.clear();
+    FramePacer::getInstance()->invalidate();
+}
+
+void ImageTier::remap(ax::Node* root) const
+{
+    if (auto sprite = dynamic_cast<ax::Sprite*>(root))
+    {
+        auto texture = sprite->getTexture();
+        auto found   = texture ? _replacements.find(texture->getPath()) : _replacements.end();
+        if (found != _replacements.end())
+        {
+            sprite->setTexture(found->second);
+            sprite->setTextureRect(ax::Rect(ax::Vec2::ZERO, found->second->getContentSize()));
+        }
+    }
+    else if (auto batch = dynamic_cast<SpriteBatchRenderer*>(root))
+    {
+        auto found = _replacements.find(batch->getTexture()->getPath());
+        if (found != _replacements.end())
+        {
+            batch->setTexture(found->second);
+        }
+    }
+    else if (auto label = dynamic_cast<ax::Label*>(root))
+    {
+        if (label->getLabelType() == ax::Label::LabelType::BMFONT)
+        {
+            std::string fontFile = label->getBMFontFilePath();
+            label->setBMFontFilePath(fontFile);
+        }
+    }
+    else if (auto staticLayer = dynamic_cast<StaticLayer*>(root))
+    {
+        staticLayer->invalidate();
+    }
+
+    for (auto child : root->getChildren())
+    {
+        remap(child);
+    }
+}
+
+void ImageTier::onLowMemory()
+{
+    Tier current = isSwitching() ? _target : _active;
+    if (current != Tier::Low)
+    {
+        requestTier(static_cast<Tier>(static_cast<int>(current) - 1));
+    }
+}
+
+void ImageTier::setThermalPressure(bool underPressure)
+{
+    if (underPressure == _hot)
+    {
+        return;
+    }
+
+    _hot = underPressure;
+    if (_hot)
+    {
+        onLowMemory();
+    }
+    else
+    {
+        restorePreferred();
+    }
+}
+
+void ImageTier::restorePreferred()
+{
+    if (!_hot)
+    {
+        requestTier(_preferred);
+    }
+}
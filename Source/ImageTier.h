@@ -0,0 +1,88 @@
+#pragma once
+
+#include "axmol/axmol.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+@brief  Chooses the images/low|mid|high search path and can switch it while running.
+
+requestTier() loads the other tier's textures with TextureCache::addImageAsync.
+Once all of them are in, the swap happens in a single scheduler tick, before the
+next draw: the search path and content scale factor change, every sprite, menu
+item image, batch renderer and BMFont label in the running scene is pointed at
+the new textures, and the old tier is dropped from the cache. Every tier is
+exported at the same size in points, but rounding to whole pixels leaves a point
+or two of difference, so scenes that derive hitboxes from sprite sizes read
+them again on EVENT_TIER_CHANGED.
+
+Scenes that are not running (under Pause or GameOver), and anything not in the
+scene graph such as SpriteFrames inside a running Animate, handle
+EVENT_TIER_CHANGED and call remap() or recreate what they own.
+*/
+class ImageTier
+{
+public:
+    enum class Tier
+    {
+        Low,
+        Mid,
+        High
+    };
+
+    static constexpr const char* EVENT_TIER_CHANGED = "image_tier_changed";
+
+    static ImageTier* getInstance();
+    static void destroyInstance();
+
+    static const char* getDirectory(Tier tier);
+
+    /**
+    @brief  Pick the tier for the window, append its directory to `searchPaths` and set the content scale.
+    Call once at launch, before the search paths are applied.
+    */
+    void init(float frameHeight, float designHeight, std::vector<std::string>& searchPaths);
+
+    Tier getActive() const { return _active; }
+    Tier getPreferred() const { return _preferred; }
+    bool isSwitching() const { return _pendingLoads > 0 || _swapScheduled; }
+
+    /** Switch tiers in the background. A request made while switching runs after the current one. */
+    void requestTier(Tier tier);
+
+    /** Drop one tier; platform low-memory signals call this. */
+    void onLowMemory();
+
+    /** Drop one tier while the device is hot and go back to the preferred tier once it cools down. */
+    void setThermalPressure(bool underPressure);
+
+    /** Go back to the tier chosen at launch, unless the device is still hot. */
+    void restorePreferred();
+
+    /** Point the textures under `root` at the new tier. Only valid while EVENT_TIER_CHANGED is dispatched. */
+    void remap(ax::Node* root) const;
+
+private:
+    ImageTier() = default;
+    float getContentScale(Tier tier) const;
+    void onTextureLoaded(uint32_t generation);
+    void trySwap(float dt);
+    void swap();
+
+    Tier _active           = Tier::High;
+    Tier _preferred        = Tier::High;
+    Tier _target           = Tier::High;
+    Tier _queued           = Tier::High;
+    bool _hasQueued        = false;
+    bool _swapScheduled    = false;
+    bool _hot              = false;
+    float _designHeight    = 1280.0f;
+    uint32_t _generation   = 0;  // bumped per request, so stale async callbacks are ignored
+    uint32_t _pendingLoads = 0;
+
+    // Old tier texture path to its replacement; filled during the swap only
+    std::unordered_map<std::string, ax::Texture2D*> _replacements;
+    std::vector<std::string> _incoming;  // full paths of the target tier's images
+};
@@ -0,0 +1,20 @@
+#include "InputQueue.h"
+
+#include <chrono>
+
+uint64_t InputQueue::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+bool InputQueue::push(InputEvent::Type type, float x, float y, int32_t code)
+{
+    if (!_ring.push(InputEvent{type, code, x, y, now()}))
+    {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "SpscRing.h"
+
+#include <cstdint>
+
+/**
+@brief  Compact input event as captured by a platform callback.
+*/
+struct InputEvent
+{
+    enum class Type : uint8_t
+    {
+        TouchBegan,
+        TouchMoved,
+        TouchEnded,
+        Acceleration,
+        KeyReleased,
+    };
+
+    Type type;
+    int32_t code;        // key code for KeyReleased
+    float x;             // touch location in GL coordinates, or acceleration
+    float y;
+    uint64_t timestamp;  // InputQueue::now() when the platform delivered the event
+};
+
+/**
+@brief  Timestamped input pipeline between the platform callbacks and the game tick.
+
+Callbacks push() events as they arrive and the scene drains them once per update,
+so event delivery is decoupled from frame processing. Single producer, single
+consumer: all callbacks must come from one thread.
+*/
+class InputQueue
+{
+public:
+    /** Monotonic high-resolution time in nanoseconds. */
+    static uint64_t now();
+
+    /** @return false when the queue is full and the event was dropped. */
+    bool push(InputEvent::Type type, float x = 0.0f, float y = 0.0f, int32_t code = 0);
+
+    /** Hand every queued event, oldest first, to `fn`. @return the number of events handled. */
+    template <typename Fn>
+    size_t drain(Fn&& fn)
+    {
+        size_t count = 0;
+        InputEvent event;
+        while (_ring.pop(event))
+        {
+            fn(event);
+            ++count;
+        }
+        return count;
+    }
+
+    size_t size() const { return _ring.size(); }
+    uint32_t getDroppedCount() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    SpscRing<InputEvent, 256> _ring;
+    std::atomic<uint32_t> _dropped{0};
+};
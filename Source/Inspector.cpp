@@ -0,0 +1,383 @@
+#include "Inspector.h"
+
+#if HAPPY_INSPECTOR
+
+#    include "FramePacer.h"
+#    include "ImGui/ImGuiPresenter.h"
+#    include "ImageTier.h"
+#    include "MemoryBudget.h"
+#    include "StaticLayer.h"
+#    include "imgui/imgui.h"
+
+#    include <algorithm>
+#    include <chrono>
+#    include <cmath>
+
+namespace
+{
+constexpr std::string_view RENDER_LOOP_ID = "#happyInspector";
+
+const char* const FRAME_GRAPH_NAMES[] = {"frame", "update", "render"};
+
+const float FRAME_RATES[] = {30.0f, 60.0f, 120.0f};
+
+Inspector* s_sharedInspector = nullptr;
+
+uint64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+}  // namespace
+
+Inspector* Inspector::getInstance()
+{
+    if (!s_sharedInspector)
+    {
+        s_sharedInspector = new Inspector();
+    }
+    return s_sharedInspector;
+}
+
+void Inspector::destroyInstance()
+{
+    delete s_sharedInspector;
+    s_sharedInspector = nullptr;
+}
+
+Inspector::Inspector()
+    : _systemNext(0)
+    , _sceneListener(nullptr)
+    , _beforeUpdateListener(nullptr)
+    , _afterUpdateListener(nullptr)
+    , _beforeDrawListener(nullptr)
+    , _afterDrawListener(nullptr)
+    , _keyboardListener(nullptr)
+    , _attachedScene(nullptr)
+    , _updateStart(0)
+    , _drawStart(0)
+    , _lastFrameEnd(0)
+    , _drawnBatches(0)
+    , _drawnVertices(0)
+    , _memorySampleAge(1.0f)
+    , _visible(true)
+{
+}
+
+Inspector::~Inspector()
+{
+    if (!_sceneListener)
+    {
+        return;
+    }
+
+    SystemTimings::setEnabled(false);
+    ax::extension::ImGuiPresenter::getInstance()->removeRenderLoop(RENDER_LOOP_ID);
+    auto dispatcher = ax::Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_sceneListener);
+    dispatcher->removeEventListener(_beforeUpdateListener);
+    dispatcher->removeEventListener(_afterUpdateListener);
+    dispatcher->removeEventListener(_beforeDrawListener);
+    dispatcher->removeEventListener(_afterDrawListener);
+    dispatcher->removeEventListener(_keyboardListener);
+}
+
+void Inspector::start(const GameConfig& config)
+{
+    if (!config.inspector || _sceneListener)
+    {
+        return;
+    }
+
+    auto dispatcher = ax::Director::getInstance()->getEventDispatcher();
+    _sceneListener  = dispatcher->addCustomEventListener(ax::Director::EVENT_AFTER_SET_NEXT_SCENE,
+                                                         [this](ax::EventCustom*) {
+        attach(ax::Director::getInstance()->getRunningScene());
+    });
+    _beforeUpdateListener = dispatcher->addCustomEventListener(ax::Director::EVENT_BEFORE_UPDATE,
+                                                               [this](ax::EventCustom*) { _updateStart = nowUs(); });
+    _afterUpdateListener  = dispatcher->addCustomEventListener(ax::Director::EVENT_AFTER_UPDATE,
+                                                               [this](ax::EventCustom*) { onAfterUpdate(); });
+    _beforeDrawListener   = dispatcher->addCustomEventListener(ax::Director::EVENT_BEFORE_DRAW,
+                                                               [this](ax::EventCustom*) { _drawStart = nowUs(); });
+    _afterDrawListener =
+        dispatcher->addCustomEventListener(ax::Director::EVENT_AFTER_DRAW, [this](ax::EventCustom*) { onAfterDraw(); });
+
+    _keyboardListener                = ax::EventListenerKeyboard::create();
+    _keyboardListener->onKeyReleased = [this](ax::EventKeyboard::KeyCode keyCode, ax::Event*) {
+        if (keyCode == ax::EventKeyboard::KeyCode::KEY_F1)
+        {
+            _visible = !_visible;
+            SystemTimings::setEnabled(_visible);
+            attach(ax::Director::getInstance()->getRunningScene());
+        }
+    };
+    dispatcher->addEventListenerWithFixedPriority(_keyboardListener, 1);
+
+    SystemTimings::setEnabled(_visible);
+    attach(ax::Director::getInstance()->getRunningScene());
+}
+
+// ImGuiPresenter draws a loop only over the scene it was added for, so the loop follows the running scene
+void Inspector::attach(ax::Scene* scene)
+{
+    auto presenter = ax::extension::ImGuiPresenter::getInstance();
+    if (_attachedScene)
+    {
+        presenter->removeRenderLoop(RENDER_LOOP_ID);
+        _attachedScene = nullptr;
+    }
+    if (_visible && scene)
+    {
+        presenter->addRenderLoop(RENDER_LOOP_ID, [this] { draw(); }, scene);
+        _attachedScene = scene;
+    }
+}
+
+void Inspector::addSection(const void* owner, std::string title, std::function<void()> fn)
+{
+    _sections.push_back(Section{owner, std::move(title), std::move(fn)});
+}
+
+void Inspector::removeSections(const void* owner)
+{
+    std::erase_if(_sections, [owner](const Section& section) { return section.owner == owner; });
+}
+
+void Inspector::Graph::push(float value)
+{
+    ms[next] = value;
+    next     = (next + 1) % HISTORY;
+}
+
+float Inspector::Graph::max() const
+{
+    return *std::max_element(ms.begin(), ms.end());
+}
+
+void Inspector::onAfterUpdate()
+{
+    if (_updateStart != 0)
+    {
+        _frameGraphs[1].push((nowUs() - _updateStart) / 1000.0f);
+        _updateStart = 0;
+    }
+}
+
+// The renderer's counters are reset when the next frame starts, so they are read here
+void Inspector::onAfterDraw()
+{
+    uint64_t now = nowUs();
+    if (_drawStart != 0)
+    {
+        _frameGraphs[2].push((now - _drawStart) / 1000.0f);
+        _drawStart = 0;
+    }
+    if (_lastFrameEnd != 0)
+    {
+        _frameGraphs[0].push((now - _lastFrameEnd) / 1000.0f);
+    }
+    _lastFrameEnd = now;
+
+    auto renderer  = ax::Director::getInstance()->getRenderer();
+    _drawnBatches  = static_cast<uint32_t>(renderer->getDrawnBatches());
+    _drawnVertices = static_cast<uint32_t>(renderer->getDrawnVertices());
+
+    auto totals = SystemTimings::take();
+    for (size_t i = 0; i < SystemTimings::COUNT; ++i)
+    {
+        _systemMs[i][_systemNext] = totals[i] / 1.0e6f;
+    }
+    _systemNext = (_systemNext + 1) % WINDOW;
+}
+
+void Inspector::draw()
+{
+    ImGui::SetNextWindowPos(ImVec2(8, 8), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Perf", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+    {
+        ImGui::End();
+        return;
+    }
+
+    drawFrameGraphs();
+    drawSystems();
+    drawRenderer();
+    drawMemory();
+    drawToggles();
+    for (const auto& section : _sections)
+    {
+        if (ImGui::CollapsingHeader(section.title.c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            section.fn();
+        }
+    }
+    ImGui::End();
+}
+
+// Scaled to twice the frame interval, so a missed refresh stands out at the same height every time
+void Inspector::drawFrameGraphs()
+{
+    if (!ImGui::CollapsingHeader("Frame times", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        return;
+    }
+
+    float scaleMs = FramePacer::getInstance()->getAnimationInterval() * 2000.0f;
+    for (size_t i = 0; i < _frameGraphs.size(); ++i)
+    {
+        const Graph& graph = _frameGraphs[i];
+        float last         = graph.ms[(graph.next + HISTORY - 1) % HISTORY];
+        std::string label  = ax::StringUtils::format("%s %.2f ms (max %.2f)", FRAME_GRAPH_NAMES[i], last, graph.max());
+        ImGui::PushID(static_cast<int>(i));
+        ImGui::PlotLines("##frameGraph", graph.ms.data(), static_cast<int>(HISTORY), static_cast<int>(graph.next),
+                         label.c_str(), 0.0f, scaleMs, ImVec2(static_cast<float>(HISTORY), 48.0f));
+        ImGui::PopID();
+    }
+}
+
+void Inspector::drawSystems()
+{
+    if (!ImGui::CollapsingHeader("Systems", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        return;
+    }
+
+    if (ImGui::BeginTable("systems", 3))
+    {
+        ImGui::TableSetupColumn("last second");
+        ImGui::TableSetupColumn("avg ms");
+        ImGui::TableSetupColumn("max ms");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < SystemTimings::COUNT; ++i)
+        {
+            const auto& ms = _systemMs[i];
+            float sum      = 0.0f;
+            for (float value : ms)
+            {
+                sum += value;
+            }
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(SystemTimings::getName(static_cast<SystemTimings::System>(i)));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", sum / WINDOW);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", *std::max_element(ms.begin(), ms.end()));
+        }
+        ImGui::EndTable();
+    }
+}
+
+void Inspector::drawRenderer()
+{
+    if (!ImGui::CollapsingHeader("Renderer", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        return;
+    }
+
+    // The overlay's own batches are counted too
+    ImGui::Text("draw calls: %u  vertices: %u", _drawnBatches, _drawnVertices);
+    ImGui::Text("static cache: %.1f Mpx fill saved", StaticLayer::getTotalPixelsSaved() / 1.0e6);
+}
+
+void Inspector::drawMemory()
+{
+    if (!ImGui::CollapsingHeader("Memory"))
+    {
+        return;
+    }
+
+    auto budget = MemoryBudget::getInstance();
+    _memorySampleAge += ImGui::GetIO().DeltaTime;
+    if (_memorySampleAge >= 1.0f)
+    {
+        budget->sample();
+        _memorySampleAge = 0.0f;
+    }
+
+    auto tier = ImageTier::getInstance();
+    ImGui::Text("image tier: %s%s", ImageTier::getDirectory(tier->getActive()),
+                tier->isSwitching() ? " (switching)" : "");
+    if (ImGui::BeginTable("memory", 3))
+    {
+        ImGui::TableSetupColumn("class");
+        ImGui::TableSetupColumn("KiB");
+        ImGui::TableSetupColumn("high KiB");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < static_cast<size_t>(MemoryBudget::AssetClass::Count); ++i)
+        {
+            auto assetClass = static_cast<MemoryBudget::AssetClass>(i);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(MemoryBudget::getClassName(assetClass));
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", budget->getResidentBytes(assetClass) / 1024);
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", budget->getHighWater(assetClass) / 1024);
+        }
+        ImGui::EndTable();
+    }
+}
+
+// Only what can change without restarting a scene; the rest stays on the command line
+void Inspector::drawToggles()
+{
+    if (!ImGui::CollapsingHeader("Modes"))
+    {
+        return;
+    }
+
+    auto director = ax::Director::getInstance();
+    bool stats    = director->isStatsDisplay();
+    if (ImGui::Checkbox("FPS stats", &stats))
+    {
+        director->setStatsDisplay(stats);
+    }
+
+    auto config = GameConfig::getInstance();
+    if (ImGui::Checkbox("static layer cache", &config->staticCache))
+    {
+        StaticLayer::setAllCachesEnabled(config->staticCache);
+    }
+
+    auto pacer   = FramePacer::getInstance();
+    float rateHz = 1.0f / pacer->getAnimationInterval();
+    ImGui::TextUnformatted("frame rate");
+    for (float rate : FRAME_RATES)
+    {
+        ImGui::SameLine();
+        std::string label = ax::StringUtils::format("%.0f Hz", rate);
+        if (ImGui::RadioButton(label.c_str(), std::abs(rateHz - rate) < 1.0f))
+        {
+            pacer->setAnimationInterval(1.0f / rate);
+        }
+    }
+
+    auto tier = ImageTier::getInstance();
+    ImGui::TextUnformatted("image tier");
+    for (auto candidate : {ImageTier::Tier::Low, ImageTier::Tier::Mid, ImageTier::Tier::High})
+    {
+        ImGui::SameLine();
+        if (ImGui::RadioButton(ImageTier::getDirectory(candidate), tier->getActive() == candidate))
+        {
+            tier->requestTier(candidate);
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("preferred"))
+    {
+        tier->restorePreferred();
+    }
+
+    // What the OS would send; handy to reproduce a purge and the reload after it
+    if (ImGui::Button("simulate low memory"))
+    {
+        MemoryBudget::getInstance()->onLowMemory();
+        tier->onLowMemory();
+    }
+}
+
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+
+/**
+@brief  ImGui performance overlay for diagnosing stutter on a device, in debug builds only.
+
+Needs the engine's ImGui extension (AX_ENABLE_EXT_IMGUI) and is compiled out of
+Release builds; see HAPPY_INSPECTOR in CMakeLists.txt. One window, collapsed
+until tapped, with:
+- frame, update and render time graphs for the last few seconds
+- time per game system (SystemTimings), averaged and worst over the last second
+- draw calls and vertices of the last frame
+- resident memory per asset class under the active image tier
+- toggles for the performance modes that can change at runtime
+- whatever the running scenes add with addSection(), e.g. entity and pool counts
+
+F1 shows and hides it on desktop.
+*/
+#if HAPPY_INSPECTOR
+
+#    include "axmol/axmol.h"
+#    include "GameConfig.h"
+#    include "SystemTimings.h"
+
+#    include <array>
+#    include <functional>
+#    include <string>
+#    include <vector>
+
+class Inspector
+{
+public:
+    static Inspector* getInstance();
+    static void destroyInstance();
+
+    /** Attach to every scene from now on. Does nothing if the `inspector` option is off. */
+    void start(const GameConfig& config);
+
+    /** Draw `fn` as a collapsible section while `owner` lives; it may call ImGui directly. */
+    void addSection(const void* owner, std::string title, std::function<void()> fn);
+    void removeSections(const void* owner);
+
+    ~Inspector();
+
+private:
+    static constexpr size_t HISTORY = 240;  // frames in the graphs, four seconds at 60 Hz
+    static constexpr size_t WINDOW  = 60;   // frames the system timings are summarized over
+
+    struct Section
+    {
+        const void* owner;
+        std::string title;
+        std::function<void()> fn;
+    };
+
+    struct Graph
+    {
+        std::array<float, HISTORY> ms{};
+        size_t next = 0;
+        void push(float value);
+        float max() const;
+    };
+
+    Inspector();
+    void attach(ax::Scene* scene);
+    void onAfterUpdate();
+    void onAfterDraw();
+    void draw();
+    void drawFrameGraphs();
+    void drawSystems();
+    void drawRenderer();
+    void drawMemory();
+    void drawToggles();
+
+    std::vector<Section> _sections;
+    std::array<Graph, 3> _frameGraphs;  // frame, update, render
+    std::array<std::array<float, WINDOW>, SystemTimings::COUNT> _systemMs{};
+    size_t _systemNext;
+    ax::EventListenerCustom* _sceneListener;
+    ax::EventListenerCustom* _beforeUpdateListener;
+    ax::EventListenerCustom* _afterUpdateListener;
+    ax::EventListenerCustom* _beforeDrawListener;
+    ax::EventListenerCustom* _afterDrawListener;
+    ax::EventListenerKeyboard* _keyboardListener;
+    ax::Scene* _attachedScene;
+    uint64_t _updateStart;
+    uint64_t _drawStart;
+    uint64_t _lastFrameEnd;
+    uint32_t _drawnBatches;
+    uint32_t _drawnVertices;
+    float _memorySampleAge;  // measuring textures walks the whole cache, so it is done once a second
+    bool _visible;
+};
+
+#endif
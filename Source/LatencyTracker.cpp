@@ -0,0 +1,142 @@
+#include "LatencyTracker.h"
+#include "InputQueue.h"
+
+#include <algorithm>
+
+namespace
+{
+LatencyTracker* s_sharedLatencyTracker = nullptr;
+
+const char* sourceName(LatencyTracker::Source source)
+{
+    switch (source)
+    {
+    case LatencyTracker::Source::Tap:
+        return "tap";
+    case LatencyTracker::Source::Drag:
+        return "drag";
+    case LatencyTracker::Source::Tilt:
+        return "tilt";
+    default:
+        return "all";
+    }
+}
+}  // namespace
+
+LatencyTracker* LatencyTracker::getInstance()
+{
+    if (!s_sharedLatencyTracker)
+    {
+        s_sharedLatencyTracker = new LatencyTracker();
+    }
+    return s_sharedLatencyTracker;
+}
+
+void LatencyTracker::destroyInstance()
+{
+    delete s_sharedLatencyTracker;
+    s_sharedLatencyTracker = nullptr;
+}
+
+LatencyTracker::LatencyTracker() : _pendingCount(0), _afterDrawListener(nullptr)
+{
+    _afterDrawListener = ax::Director::getInstance()->getEventDispatcher()->addCustomEventListener(
+        ax::Director::EVENT_AFTER_DRAW, [this](ax::EventCustom*) { onFrameSubmitted(); });
+}
+
+LatencyTracker::~LatencyTracker()
+{
+    ax::Director::getInstance()->getEventDispatcher()->removeEventListener(_afterDrawListener);
+}
+
+void LatencyTracker::inputApplied(Source source, uint64_t timestamp)
+{
+    if (_pendingCount < _pending.size())
+    {
+        _pending[_pendingCount++] = PendingInput{source, timestamp};
+    }
+}
+
+void LatencyTracker::onFrameSubmitted()
+{
+    if (_pendingCount == 0)
+    {
+        return;
+    }
+
+    uint64_t now = InputQueue::now();
+    for (size_t i = 0; i < _pendingCount; ++i)
+    {
+        float ms = static_cast<float>(now - _pending[i].timestamp) / 1.0e6f;
+        _histograms[static_cast<size_t>(_pending[i].source)].add(ms);
+        _histograms[static_cast<size_t>(Source::All)].add(ms);
+    }
+    _pendingCount = 0;
+}
+
+void LatencyTracker::Histogram::add(float ms)
+{
+    int bucket = std::clamp(static_cast<int>(ms / BUCKET_MS), 0, BUCKET_COUNT - 1);
+    ++buckets[bucket];
+    ++count;
+    max = std::max(max, ms);
+}
+
+float LatencyTracker::Histogram::percentile(float p) const
+{
+    if (count == 0)
+    {
+        return 0.0f;
+    }
+
+    uint32_t rank = std::max(1u, static_cast<uint32_t>(p * count + 0.5f));
+    uint32_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+        {
+            // Report the bucket's upper edge, but never more than the slowest sample
+            return std::min((i + 1) * BUCKET_MS, max);
+        }
+    }
+    return max;
+}
+
+float LatencyTracker::getPercentile(Source source, float p) const
+{
+    return _histograms[static_cast<size_t>(source)].percentile(p);
+}
+
+uint32_t LatencyTracker::getSampleCount(Source source) const
+{
+    return _histograms[static_cast<size_t>(source)].count;
+}
+
+std::string LatencyTracker::getSummary() const
+{
+    const auto& all = _histograms[static_cast<size_t>(Source::All)];
+    return ax::StringUtils::format("input p50 %.1f p95 %.1f p99 %.1f ms", all.percentile(0.50f),
+                                   all.percentile(0.95f), all.percentile(0.99f));
+}
+
+bool LatencyTracker::writeReport() const
+{
+    std::string report = "source samples p50_ms p95_ms p99_ms max_ms\n";
+    for (size_t i = 0; i < _histograms.size(); ++i)
+    {
+        const auto& histogram = _histograms[i];
+        report += ax::StringUtils::format("%s %u %.2f %.2f %.2f %.2f\n", sourceName(static_cast<Source>(i)),
+                                          histogram.count, histogram.percentile(0.50f), histogram.percentile(0.95f),
+                                          histogram.percentile(0.99f), histogram.max);
+    }
+
+    auto fileUtils = ax::FileUtils::getInstance();
+    return fileUtils->writeStringToFile(report, fileUtils->getWritablePath() + "input_latency.txt");
+}
+
+void LatencyTracker::reset()
+{
+    _histograms.fill(Histogram{});
+    _pendingCount = 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "axmol/axmol.h"
+
+#include <array>
+
+/**
+@brief  End-to-end input latency: from platform delivery to the frame that shows it.
+
+The scene reports each input event it applies, with the InputQueue timestamp it
+arrived with. When the frame is submitted (Director::EVENT_AFTER_DRAW) the elapsed
+time of every input applied during that frame becomes one sample. Samples go into
+fixed-size histograms, so tracking never allocates.
+*/
+class LatencyTracker
+{
+public:
+    enum class Source
+    {
+        Tap,   // explodeBombs
+        Drag,  // movePlayerByTouch
+        Tilt,  // movePlayerByAccelerometer
+        All,
+    };
+
+    static LatencyTracker* getInstance();
+    static void destroyInstance();
+
+    /** Record that an input with InputQueue timestamp `timestamp` was applied in this frame. */
+    void inputApplied(Source source, uint64_t timestamp);
+
+    /** Latency percentile in milliseconds, `p` in [0, 1]. Returns 0 without samples. */
+    float getPercentile(Source source, float p) const;
+    uint32_t getSampleCount(Source source) const;
+
+    /** One-line p50/p95/p99 summary for the stats overlay. */
+    std::string getSummary() const;
+
+    /** Write the per-session report to the writable path. */
+    bool writeReport() const;
+
+    void reset();
+
+    ~LatencyTracker();
+
+private:
+    LatencyTracker();
+    void onFrameSubmitted();
+
+    static constexpr float BUCKET_MS  = 0.25f;
+    static constexpr int BUCKET_COUNT = 2000;  // 500 ms; slower samples land in the last bucket
+
+    struct Histogram
+    {
+        std::array<uint32_t, BUCKET_COUNT> buckets{};
+        uint32_t count = 0;
+        float max      = 0.0f;
+
+        void add(float ms);
+        float percentile(float p) const;
+    };
+
+    struct PendingInput
+    {
+        Source source;
+        uint64_t timestamp;
+    };
+
+    std::array<Histogram, static_cast<size_t>(Source::All) + 1> _histograms;
+    std::array<PendingInput, 64> _pending;
+    size_t _pendingCount;
+    ax::EventListenerCustom* _afterDrawListener;
+};
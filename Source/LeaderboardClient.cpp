@@ -0,0 +1,326 @@
+#include "LeaderboardClient.h"
+#include "FramePacer.h"
+#include "Percentile.h"
+#include "axmol/network/HttpClient.h"
+
+#include <algorithm>
+#include <ctime>
+#include <sstream>
+
+namespace
+{
+// Scores made within this window go out in the same request
+constexpr float BATCH_WINDOW  = 1.0f;
+constexpr float TICK_INTERVAL = 0.25f;
+constexpr float BACKOFF_BASE  = 2.0f;
+constexpr float BACKOFF_MAX   = 300.0f;
+
+LeaderboardClient* s_sharedLeaderboardClient = nullptr;
+
+std::string queuePath()
+{
+    return ax::FileUtils::getInstance()->getWritablePath() + "leaderboard_queue.txt";
+}
+
+std::chrono::steady_clock::duration seconds(float value)
+{
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(value));
+}
+
+float millisecondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+    return std::chrono::duration<float, std::milli>(to - from).count();
+}
+}  // namespace
+
+LeaderboardClient* LeaderboardClient::getInstance()
+{
+    if (!s_sharedLeaderboardClient)
+    {
+        s_sharedLeaderboardClient = new LeaderboardClient();
+    }
+    return s_sharedLeaderboardClient;
+}
+
+void LeaderboardClient::destroyInstance()
+{
+    delete s_sharedLeaderboardClient;
+    s_sharedLeaderboardClient = nullptr;
+}
+
+LeaderboardClient::LeaderboardClient()
+    : _inFlight(0)
+    , _request(nullptr)
+    , _attempts(0)
+    , _rng(static_cast<uint64_t>(Clock::now().time_since_epoch().count()))
+    , _maxDepth(0)
+    , _accepted(0)
+    , _rejected(0)
+    , _retries(0)
+{
+    // Random, not derived from the device, and kept across launches
+    auto userDefault = ax::UserDefault::getInstance();
+    _playerId        = userDefault->getStringForKey("leaderboard_player");
+    if (_playerId.empty())
+    {
+        _playerId = ax::StringUtils::format("%08x%08x", _rng.next(), _rng.next());
+        userDefault->setStringForKey("leaderboard_player", _playerId);
+    }
+}
+
+LeaderboardClient::~LeaderboardClient()
+{
+    ax::Director::getInstance()->getScheduler()->unscheduleAllForTarget(this);
+    if (_request)
+    {
+        // HttpClient may still answer it; nobody is listening any more
+        _request->setResponseCallback(nullptr);
+        _request->release();
+    }
+}
+
+void LeaderboardClient::setUrl(std::string_view url)
+{
+    auto scheduler = ax::Director::getInstance()->getScheduler();
+    _url           = url;
+    if (_url.empty())
+    {
+        scheduler->unscheduleAllForTarget(this);
+        FramePacer::getInstance()->setBusy(this, false);
+        return;
+    }
+
+    if (_entries.empty())
+    {
+        load();
+    }
+    _nextAttempt = Clock::now();
+    scheduler->schedule([this](float) { tick(); }, this, TICK_INTERVAL, false, "LeaderboardClient.tick");
+    updateBusy();
+}
+
+void LeaderboardClient::submit(int score, Callback callback, std::string_view player)
+{
+    if (!isEnabled())
+    {
+        if (callback)
+        {
+            callback(false);
+        }
+        return;
+    }
+    if (player.empty())
+    {
+        player = _playerId;
+    }
+
+    // Only the best unsent score of a player matters; entries already on the wire are left alone
+    auto now   = Clock::now();
+    auto found = std::find_if(_entries.begin() + _inFlight, _entries.end(),
+                              [player](const Entry& entry) { return entry.player == player; });
+    if (found == _entries.end())
+    {
+        if (_entries.size() == _inFlight && _attempts == 0)
+        {
+            _nextAttempt = now + seconds(BATCH_WINDOW);
+        }
+        _entries.push_back(Entry{std::string(player), score, static_cast<int64_t>(time(nullptr)), now, {}});
+        found = _entries.end() - 1;
+    }
+    else if (score > found->score)
+    {
+        found->score = score;
+        found->time  = static_cast<int64_t>(time(nullptr));
+    }
+    if (callback)
+    {
+        found->callbacks.push_back(std::move(callback));
+    }
+
+    _maxDepth = std::max(_maxDepth, _entries.size());
+    save();
+    updateBusy();
+}
+
+// Scores submitted just before GameOver goes idle still have to be sent, and answered, before the pacer may
+// sleep. A queue waiting out a backoff does not hold it: the retry runs when the game next draws, or next launch.
+void LeaderboardClient::updateBusy()
+{
+    bool busy = _request || (_entries.size() > _inFlight && _attempts == 0);
+    FramePacer::getInstance()->setBusy(this, busy);
+}
+
+void LeaderboardClient::tick()
+{
+    if (!_request && _inFlight == 0 && !_entries.empty() && Clock::now() >= _nextAttempt)
+    {
+        send();
+    }
+}
+
+void LeaderboardClient::send()
+{
+    _inFlight = std::min(_entries.size(), MAX_BATCH);
+
+    std::string body = "{\"scores\":[";
+    for (size_t i = 0; i < _inFlight; ++i)
+    {
+        const Entry& entry = _entries[i];
+        body += ax::StringUtils::format("%s{\"player\":\"%s\",\"score\":%d,\"time\":%lld}", i > 0 ? "," : "",
+                                        entry.player.c_str(), entry.score, static_cast<long long>(entry.time));
+    }
+    body += "]}";
+
+    _request = new ax::network::HttpRequest();
+    _request->setUrl(_url);
+    _request->setRequestType(ax::network::HttpRequest::Type::POST);
+    _request->setHeaders({"Content-Type: application/json"});
+    _request->setRequestData(body.data(), body.size());
+    // HttpClient delivers responses on the main thread
+    _request->setResponseCallback(
+        [this](ax::network::HttpClient*, ax::network::HttpResponse* response) { onResponse(response); });
+
+    _sentAt = Clock::now();
+    ax::network::HttpClient::getInstance()->send(_request);
+}
+
+void LeaderboardClient::onResponse(ax::network::HttpResponse* response)
+{
+    auto now = Clock::now();
+    _roundTrips.push_back(millisecondsBetween(_sentAt, now));
+    _request->release();
+    _request = nullptr;
+
+    size_t count = _inFlight;
+    _inFlight    = 0;
+
+    int code = static_cast<int>(response->getResponseCode());
+    if (response->isSucceed() && code >= 200 && code < 300)
+    {
+        complete(count, true);
+    }
+    else if (code >= 400 && code < 500 && code != 408 && code != 429)
+    {
+        AXLOGW("Leaderboard: server rejected {} scores with HTTP {}", count, code);
+        complete(count, false);
+    }
+    else
+    {
+        AXLOGI("Leaderboard: HTTP {}, retrying {} scores later", code, count);
+        retryLater();
+    }
+    updateBusy();
+}
+
+void LeaderboardClient::complete(size_t count, bool accepted)
+{
+    auto now = Clock::now();
+    std::vector<Entry> done(std::make_move_iterator(_entries.begin()),
+                            std::make_move_iterator(_entries.begin() + count));
+    _entries.erase(_entries.begin(), _entries.begin() + count);
+    _attempts    = 0;
+    _nextAttempt = now;
+    save();
+
+    for (auto& entry : done)
+    {
+        _latencies.push_back(millisecondsBetween(entry.queued, now));
+        if (accepted)
+        {
+            ++_accepted;
+        }
+        else
+        {
+            ++_rejected;
+        }
+        // Callbacks may submit again, which is why the queue is settled first
+        for (auto& callback : entry.callbacks)
+        {
+            callback(accepted);
+        }
+    }
+}
+
+void LeaderboardClient::retryLater()
+{
+    ++_attempts;
+    ++_retries;
+
+    // Jittered, so clients that lost the server together do not come back together
+    float delay = std::min(BACKOFF_MAX, BACKOFF_BASE * static_cast<float>(1u << std::min(_attempts - 1, 16u)));
+    delay *= _rng.range(0.5f, 1.0f);
+    _nextAttempt = Clock::now() + seconds(delay);
+}
+
+// One `player score time` line per entry after a version line
+void LeaderboardClient::load()
+{
+    auto fileUtils = ax::FileUtils::getInstance();
+    if (!fileUtils->isFileExist(queuePath()))
+    {
+        return;
+    }
+
+    std::istringstream lines(fileUtils->getStringFromFile(queuePath()));
+    std::string header;
+    if (!std::getline(lines, header) || header != "HLBQ 1")
+    {
+        return;
+    }
+
+    auto now = Clock::now();
+    Entry entry{{}, 0, 0, now, {}};
+    long long entryTime = 0;
+    while (lines >> entry.player >> entry.score >> entryTime)
+    {
+        entry.time = entryTime;
+        _entries.push_back(entry);
+    }
+    _maxDepth = std::max(_maxDepth, _entries.size());
+    if (!_entries.empty())
+    {
+        AXLOGI("Leaderboard: {} unsent scores from an earlier session", _entries.size());
+    }
+}
+
+void LeaderboardClient::save() const
+{
+    std::string text = "HLBQ 1\n";
+    for (const auto& entry : _entries)
+    {
+        text += ax::StringUtils::format("%s %d %lld\n", entry.player.c_str(), entry.score,
+                                        static_cast<long long>(entry.time));
+    }
+
+    // Written next to the queue and renamed, so a crash mid-write keeps the previous queue. Not std::rename,
+    // which fails on Windows once the queue exists; FileUtils replaces it on every platform.
+    auto fileUtils        = ax::FileUtils::getInstance();
+    std::string path      = queuePath();
+    std::string writePath = path + ".tmp";
+    if (!fileUtils->writeStringToFile(text, writePath) || !fileUtils->renameFile(writePath, path))
+    {
+        AXLOGW("Leaderboard: cannot save the queue to {}", path);
+    }
+}
+
+std::string LeaderboardClient::getReport()
+{
+    std::string report;
+    report += ax::StringUtils::format("accepted: %u\n", _accepted);
+    report += ax::StringUtils::format("rejected: %u\n", _rejected);
+    report += ax::StringUtils::format("retries: %u\n", _retries);
+    report += ax::StringUtils::format("queue_depth: %zu\n", _entries.size());
+    report += ax::StringUtils::format("max_queue_depth: %zu\n", _maxDepth);
+    report += ax::StringUtils::format("submit_latency_ms p50 %.1f p95 %.1f max %.1f\n",
+                                      percentileOf(_latencies, 0.50f), percentileOf(_latencies, 0.95f),
+                                      percentileOf(_latencies, 1.0f));
+    report += ax::StringUtils::format("request_ms p50 %.1f p95 %.1f max %.1f\n", percentileOf(_roundTrips, 0.50f),
+                                      percentileOf(_roundTrips, 0.95f), percentileOf(_roundTrips, 1.0f));
+    return report;
+}
+
+bool LeaderboardClient::writeReport()
+{
+    auto fileUtils = ax::FileUtils::getInstance();
+    return fileUtils->writeStringToFile(getReport(), fileUtils->getWritablePath() + "leaderboard_report.txt");
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "axmol/axmol.h"
+#include "Rng.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ax::network
+{
+class HttpRequest;
+class HttpResponse;
+}  // namespace ax::network
+
+/**
+@brief  Queue of leaderboard scores sent in the background through HttpClient.
+
+submit() never blocks: the score goes into a queue that is also written to
+`<writable path>/leaderboard_queue.txt`, so scores made offline or before a
+crash are sent on a later launch. Unsent scores of the same player coalesce
+into the best one. Up to MAX_BATCH players go in one POST once the batch window
+has passed. Failed requests are retried with jittered exponential backoff;
+4xx answers other than 408 and 429 drop the batch for good.
+
+Callbacks run on the main thread once the score is accepted or rejected.
+Submission latency and queue depth are written to leaderboard_report.txt.
+tools/mock_leaderboard.py serves the endpoint locally.
+*/
+class LeaderboardClient
+{
+public:
+    using Callback = std::function<void(bool accepted)>;
+
+    static LeaderboardClient* getInstance();
+    static void destroyInstance();
+
+    /** Endpoint that takes the POSTed batches. Loads the persisted queue and starts sending. Empty disables. */
+    void setUrl(std::string_view url);
+    bool isEnabled() const { return !_url.empty(); }
+
+    /** Queue `score` for `player`, by default this device's player id. */
+    void submit(int score, Callback callback = nullptr, std::string_view player = {});
+
+    const std::string& getPlayerId() const { return _playerId; }
+    size_t getQueueDepth() const { return _entries.size(); }
+
+    std::string getReport();
+
+    /** Write getReport() to leaderboard_report.txt in the writable path. */
+    bool writeReport();
+
+    ~LeaderboardClient();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        std::string player;
+        int score;
+        int64_t time;              // unix seconds when the score was made
+        Clock::time_point queued;  // when it entered this session's queue
+        std::vector<Callback> callbacks;
+    };
+
+    static constexpr size_t MAX_BATCH = 32;
+
+    LeaderboardClient();
+    void tick();
+    void send();
+    void onResponse(ax::network::HttpResponse* response);
+    void complete(size_t count, bool accepted);
+    void retryLater();
+    void updateBusy();
+    void load();
+    void save() const;
+
+    std::string _url;
+    std::string _playerId;
+    std::vector<Entry> _entries;  // the first _inFlight entries are in the request being sent
+    size_t _inFlight;
+    ax::network::HttpRequest* _request;
+    Clock::time_point _sentAt;
+    Clock::time_point _nextAttempt;
+    uint32_t _attempts;
+    Rng _rng;
+
+    size_t _maxDepth;
+    uint32_t _accepted;
+    uint32_t _rejected;
+    uint32_t _retries;
+    std::vector<float> _latencies;   // ms from submit() to acknowledgement
+    std::vector<float> _roundTrips;  // ms per request
+};
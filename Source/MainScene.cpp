@@ -1,17 +1,67 @@
 #include "MainScene.h"
 #include "GameOverScene.h"
 #include "PauseScene.h"
-#include "axmol/audio/AudioEngine.h"
+#include "ParticlePack.h"
+#include "LatencyTracker.h"
+#include "AllocTracker.h"
+#include "StaticLayer.h"
+#include "AppDelegate.h"
+#include "SfxCache.h"
+#include "AudioStartup.h"
+#include "ImageTier.h"
+#include "LeaderboardClient.h"
+#include "Inspector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if HAPPY_INSPECTOR
+#    include "imgui/imgui.h"
+#endif
 
 ax::Scene* MainScene::createScene()
 {
     auto scene = ax::Scene::create();
+    scene->setName("MainScene");  // FrameTelemetry keys its histograms by scene name
     auto layer = ax::utils::createInstance<MainScene>();
     scene->addChild(layer);
 
     return scene;
 }
 
+// Enough bomb slots for the default spawn rate, so steady-state gameplay never allocates
+static constexpr size_t BOMB_RESERVE = 64;
+
+static constexpr int PLAYER_ANIMATION_TAG = 1;
+
+// How often the autoplay bot gets to move, in game time
+static constexpr float AUTOPLAY_INTERVAL = 0.1f;
+
+static constexpr float MUSIC_FADE_IN_SECONDS = 1.5f;
+
+// Spread replacements over the whole screen so every live bomb is drawn
+static void topUpStressBombs(GameRound& round, const StressTest& stressTest, const ax::Size& field)
+{
+    Rng& rng = round.getRng();
+    while (round.getBombCount() < stressTest.getTargetBombs())
+    {
+        round.spawnBomb(ax::Vec2(rng.next01() * field.width, rng.next01() * field.height));
+    }
+}
+
+// A dead slot keeps its place as an empty quad, so the slots around it need no rewriting
+static void writeBomb(SpriteBatchRenderer& renderer, const GameRound& round, size_t slot)
+{
+    const Bomb& bomb  = round.getBomb(slot);
+    auto& instance    = renderer.at(slot);
+    instance.position = bomb.spawnPosition;
+    instance.rotation = 0.0f;
+    instance.scale    = bomb.alive ? 1.0f : 0.0f;
+    instance.velocity = ax::Vec2(0.0f, -bomb.speed);
+    instance.time     = static_cast<float>(bomb.spawnedAt);
+}
+
 static void printLoadingError(const char* filename)
 {
     printf("Error while loading: %s\n", filename);
@@ -27,8 +77,8 @@ bool MainScene::init()
         return false;
     }
 
-    _score       = 0;
     _director    = ax::Director::getInstance();
+    _config      = GameConfig::getInstance();
     _visibleSize = _director->getVisibleSize();
 
     auto pauseItem =
@@ -65,23 +115,58 @@ bool MainScene::init()
     _sprPlayer->setPosition(_visibleSize.width / 2, _visibleSize.height * 0.23);
     this->addChild(_sprPlayer, 0);
 
-    // Animations
-    ax::Vector<ax::SpriteFrame*> frames;
-    ax::Size playerSize = _sprPlayer->getContentSize();
-    frames.pushBack(ax::SpriteFrame::create("player.png", ax::Rect(0, 0, playerSize.width, playerSize.height)));
-    frames.pushBack(ax::SpriteFrame::create("player2.png", ax::Rect(0, 0, playerSize.width, playerSize.height)));
-    auto animation = ax::Animation::createWithSpriteFrames(frames, 0.2f);
-    auto animate   = ax::Animate::create(animation);
-    _sprPlayer->runAction(ax::RepeatForever::create(animate));
+    runPlayerAnimation();
+
+    _bombRenderer = SpriteBatchRenderer::create("bomb.png");
+    if (!_bombRenderer)
+    {
+        printLoadingError("bomb.png");
+        return false;
+    }
+    _bombRenderer->reserve(BOMB_RESERVE);
+    this->addChild(_bombRenderer, 1);
+
+    GameRules rules = GameRules::fromConfig(*_config);
+    if (_config->stress)
+    {
+        _stressTest = std::make_unique<StressTest>(*_config);
+        // The stress test keeps its own bomb count topped up before every step
+        rules.spawnInterval = 0.0f;
+    }
+    _round.setRules(rules);
+    // Point sizes agree between image tiers only to within rounding, so a swap sets them again
+    _round.setField(_visibleSize, _sprPlayer->getContentSize(), _bombRenderer->getInstanceSize());
+    _round.reserve(BOMB_RESERVE);
+    if (_config->threadedSim)
+    {
+        initSimThread();
+    }
+    // The threaded sim hands over a fresh copy of every bomb each frame, so only a round stepped here falls on the GPU
+    if (_config->gpuBombMotion && !_sim)
+    {
+        _round.setTrackBombChanges(_bombRenderer->setMotionEnabled(true));
+    }
 
     initTouch();
     initAccelerometer();
     initBackButtonListener();
-    schedule(AX_SCHEDULE_SELECTOR(MainScene::updateScore), 3.0f);
-    schedule(AX_SCHEDULE_SELECTOR(MainScene::addBombs), 8.0f);
-    addBombs(0.0f);
+    initSnapshotListeners();
+    _tierListener = _director->getEventDispatcher()->addCustomEventListener(
+        ImageTier::EVENT_TIER_CHANGED, [this](ax::EventCustom*) { onImageTierChanged(); });
+
+    uint64_t seed = _config->seed;
+    if (seed == 0)
+    {
+        seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+    _round.setSeed(seed);
+
+    resetRound();
+    restoreSnapshot();
     initAudioNewEngine();
     initMuteButton();
+    initLatencyOverlay();
+    initInspectorSection();
     scheduleUpdate();
 
     return true;
@@ -90,122 +175,439 @@ bool MainScene::init()
 void MainScene::onEnter()
 {
     Node::onEnter();
+
+    // Back from GameOver: play again on the existing scene graph, textures, listeners and audio
+    if (_gameState == GameState::end)
+    {
+        resetRound();
+        _music.rewind();
+        _music.play();
+    }
+    else
+    {
+        resumeSim();
+    }
+}
+
+void MainScene::onExit()
+{
+    // Under Pause or in a transition the round must not move on
+    if (_sim)
+    {
+        _sim->stop();
+    }
+    Node::onExit();
 }
 
-// Move the player if it does not go outside of the screen
-void MainScene::movePlayerIfPossible(float newX)
+// The round steps on its own thread and the main thread only draws the frames it publishes
+void MainScene::initSimThread()
 {
-    float sprHalfWidth = _sprPlayer->getBoundingBox().size.width / 2;
-    if (newX >= sprHalfWidth && newX < _visibleSize.width - sprHalfWidth)
+#if AX_TARGET_PLATFORM == AX_PLATFORM_WASM
+    AXLOGI("threaded-sim: no threads on this platform, the round steps in update()");
+#else
+    if (std::thread::hardware_concurrency() < 2)
     {
-        _sprPlayer->setPositionX(newX);
+        AXLOGI("threaded-sim: single core, the round steps in update()");
+        return;
     }
+
+    _sim = std::make_unique<SimThread>(_round, _inputQueue, std::max(_config->threadedSimHz, 1.0f), BOMB_RESERVE);
+    _sim->setSuggestBotMoves(_config->autoplay);
+    if (_stressTest)
+    {
+        const StressTest* stressTest = _stressTest.get();
+        ax::Size field               = _visibleSize;
+        _sim->setStepHook(
+            [stressTest, field](GameRound& round) { topUpStressBombs(round, *stressTest, field); });
+    }
+#endif
 }
 
-void MainScene::movePlayerByTouch(ax::Touch* touch, ax::Event* event)
+// Only while the round is live and on screen; a paused round resumes from onEnter()
+void MainScene::resumeSim()
 {
-    ax::Vec2 touchLocation = touch->getLocation();
-    if (_sprPlayer->getBoundingBox().containsPoint(touchLocation))
+    if (_sim && isRunning() && _gameState == GameState::update)
+    {
+        _sim->start();
+    }
+}
+
+// Reinitialize only the gameplay state of a round
+void MainScene::resetRound()
+{
+    if (_sim)
+    {
+        _sim->stop();
+    }
+    _gameState = GameState::init;
+    _round.reset(!_stressTest);
+    syncRound();
+
+    _timeline.clear();
+    _timeline.start(playRound(_timeline));
+    if (_config->autoplay)
     {
-        movePlayerIfPossible(touchLocation.x);
+        _timeline.start(autoplay(_timeline));
     }
 }
 
-bool MainScene::explodeBombs(ax::Touch* touch, ax::Event* event)
+// One round from the reset to the collision, a frame at a time
+Timeline::Task MainScene::playRound(Timeline& timeline)
 {
-    ax::Vec2 touchLocation = touch->getLocation();
-    ax::Vector<ax::Sprite*> toErase;
+    // The frame of the reset only makes the round live; the first step comes a frame later
+    co_await timeline.nextFrame();
+    _gameState = GameState::update;
 
-    for (auto bomb : _bombs)
+    if (_sim)
+    {
+        co_await followSim(timeline);
+    }
+    else
     {
-        if (bomb->getBoundingBox().containsPoint(touchLocation))
+        for (;;)
         {
-            ax::AudioEngine::play2d("bomb.mp3");
-            auto explosion = ax::ParticleExplosion::create();
-            explosion->setPosition(bomb->getPosition());
-            this->addChild(explosion);
-            bomb->setVisible(false);
-            this->removeChild(bomb);
-            toErase.pushBack(bomb);
+            co_await timeline.nextFrame();
+
+            if (_stressTest)
+            {
+                topUpStressBombs(_round, *_stressTest, _visibleSize);
+            }
+
+            bool alive = _round.step(timeline.getDelta());
+            syncRound();
+            if (!alive)
+            {
+                break;
+            }
         }
     }
 
-    for (auto bomb : toErase)
+    onCollision();
+}
+
+// Threaded sim: draw the newest frame each frame until one shows the collision
+Timeline::Task MainScene::followSim(Timeline& timeline)
+{
+    auto onEvent = [this](const SimThread::Event& event) { onSimEvent(event); };
+
+    _sim->start();
+    for (;;)
     {
-        _bombs.eraseObject(bomb);
+        co_await timeline.nextFrame();
+
+        // Events first: each one belongs to a frame that latest() returns or has passed
+        _sim->drainEvents(onEvent);
+        const RoundFrame& frame = _sim->latest();
+        showFrame(frame);
+        if (frame.over)
+        {
+            break;
+        }
     }
 
-    return true;
+    // The thread has ended by itself; the round is the scene's again
+    _sim->stop();
+    _sim->drainEvents(onEvent);
+    syncRound();
 }
 
-void MainScene::initTouch()
+void MainScene::showFrame(const RoundFrame& frame)
 {
-    auto listener          = ax::EventListenerTouchOneByOne::create();
-    listener->onTouchBegan = AX_CALLBACK_2(MainScene::explodeBombs, this);
-    listener->onTouchMoved = AX_CALLBACK_2(MainScene::movePlayerByTouch, this);
-    listener->onTouchEnded = [=](ax::Touch* touch, ax::Event* event) {};
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+    // Bombs fall at a constant speed, so move them on by the frame's age; at most a step, should the thread stall
+    float age = std::min((InputQueue::now() - frame.published) / 1.0e9f, _sim->getStep());
+
+    _sprPlayer->setPosition(frame.player);
+    _bombRenderer->resize(frame.bombs.size());
+    for (size_t i = 0; i < frame.bombs.size(); ++i)
+    {
+        _bombRenderer->at(i).position = ax::Vec2(frame.bombs[i].x, frame.bombs[i].y - frame.speeds[i] * age);
+    }
 }
 
-void MainScene::initAccelerometer()
+void MainScene::onSimEvent(const SimThread::Event& event)
 {
-    ax::Device::setAccelerometerEnabled(true);
-    auto listener = ax::EventListenerAcceleration::create(AX_CALLBACK_2(MainScene::movePlayerByAccelerometer, this));
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+    if (event.type == SimThread::Event::Type::Explosion)
+    {
+        showExplosion(event.position);
+        return;
+    }
+
+    auto latency = LatencyTracker::getInstance();
+    switch (event.input.type)
+    {
+    case InputEvent::Type::TouchBegan:
+        latency->inputApplied(LatencyTracker::Source::Tap, event.input.timestamp);
+        break;
+    case InputEvent::Type::TouchMoved:
+        latency->inputApplied(LatencyTracker::Source::Drag, event.input.timestamp);
+        break;
+    case InputEvent::Type::Acceleration:
+        latency->inputApplied(LatencyTracker::Source::Tilt, event.input.timestamp);
+        break;
+    case InputEvent::Type::KeyReleased:
+        onKeyPressed(static_cast<ax::EventKeyboard::KeyCode>(event.input.code), nullptr);
+        break;
+    default:
+        break;
+    }
 }
 
-void MainScene::movePlayerByAccelerometer(ax::Acceleration* acceleration, ax::Event* event)
+// The round is the truth; sprites only show it
+void MainScene::syncRound()
 {
-    movePlayerIfPossible(_sprPlayer->getPositionX() + (acceleration->x * 10));
+    _sprPlayer->setPosition(_round.getPlayerPosition());
+
+    if (!_bombRenderer->isMotionEnabled())
+    {
+        size_t i = 0;
+        _bombRenderer->resize(_round.getBombCount());
+        _round.forEachBomb([this, &i](const ax::Vec2& position, float) {
+            _bombRenderer->at(i++) = SpriteBatchRenderer::Instance{position, 0.0f, 1.0f, ax::Vec2::ZERO, 0.0f};
+        });
+        return;
+    }
+
+    // With GPU motion a bomb is written once, into its own slot as it spawned, and again when it goes
+    _bombRenderer->resize(_round.getBombSlotCount());
+    if (_round.getBombRevision() != _syncedBombRevision)
+    {
+        // Every slot is written anyway
+        _round.takeBombChanges([](size_t) {});
+        for (size_t slot = 0; slot < _round.getBombSlotCount(); ++slot)
+        {
+            writeBomb(*_bombRenderer, _round, slot);
+        }
+        _bombRenderer->invalidate();
+        _syncedBombRevision = _round.getBombRevision();
+    }
+    else
+    {
+        _round.takeBombChanges([this](size_t slot) {
+            writeBomb(*_bombRenderer, _round, slot);
+            _bombRenderer->invalidate(slot);
+        });
+    }
+    _bombRenderer->setMotionTime(static_cast<float>(_round.getTime()));
 }
 
-void MainScene::onCollision()
+// Animation frames are not in the scene graph, so ImageTier cannot remap them; rebuilding picks up the active tier
+void MainScene::runPlayerAnimation()
 {
-    _gameState = GameState::pause;
+    ax::Vector<ax::SpriteFrame*> frames;
+    ax::Size playerSize = _sprPlayer->getContentSize();
+    frames.pushBack(ax::SpriteFrame::create("player.png", ax::Rect(0, 0, playerSize.width, playerSize.height)));
+    frames.pushBack(ax::SpriteFrame::create("player2.png", ax::Rect(0, 0, playerSize.width, playerSize.height)));
+    auto animation = ax::Animation::createWithSpriteFrames(frames, 0.2f);
+    auto animate   = ax::RepeatForever::create(ax::Animate::create(animation));
+    animate->setTag(PLAYER_ANIMATION_TAG);
+    _sprPlayer->stopActionByTag(PLAYER_ANIMATION_TAG);
+    _sprPlayer->runAction(animate);
+}
 
-    if (_muteItem->isVisible())
+void MainScene::onImageTierChanged()
+{
+    // The running scene is remapped already; under Pause or GameOver this layer is not part of it
+    if (!isRunning())
     {
-        ax::AudioEngine::stopAll();
-        ax::AudioEngine::play2d("uh.mp3");
+        ImageTier::getInstance()->remap(this);
     }
+    runPlayerAnimation();
 
-    ax::UserDefault::getInstance()->setIntegerForKey("score", _score);
-    _director->replaceScene(ax::TransitionFlipX::create(1.0, GameOver::createScene()));
+    // Hitboxes follow the sprites; the sim thread must not be stepping while they change
+    if (_sim)
+    {
+        _sim->stop();
+    }
+    _round.setField(_visibleSize, _sprPlayer->getContentSize(), _bombRenderer->getInstanceSize());
+    resumeSim();
 }
 
-void MainScene::updateScore(float dt)
+void MainScene::initSnapshotListeners()
 {
-    _score += 10;
+    auto dispatcher     = _director->getEventDispatcher();
+    _backgroundListener = dispatcher->addCustomEventListener(AppDelegate::EVENT_DID_ENTER_BACKGROUND,
+                                                             [this](ax::EventCustom*) {
+        // Nothing is drawn in the background, so the round would go on unseen
+        if (_sim)
+        {
+            _sim->stop();
+        }
+        saveSnapshot();
+    });
+
+    // Back by ourselves, so the snapshot must not resurrect this round on a later launch
+    _foregroundListener = dispatcher->addCustomEventListener(AppDelegate::EVENT_WILL_ENTER_FOREGROUND,
+                                                             [this](ax::EventCustom*) {
+        GameSnapshot::discard();
+        resumeSim();
+    });
 }
 
-void MainScene::addBombs(float dt)
+// Called while backgrounded, also from under Pause; only a live round is worth keeping
+void MainScene::saveSnapshot()
 {
-    for (int i = 0; i < 3; i++)
+    if (_gameState == GameState::end || _stressTest)
+    {
+        return;
+    }
+
+    _round.save(_snapshot);
+    if (!_snapshot.save(_snapshotBuffer))
     {
-        auto bomb    = ax::Sprite::create("bomb.png");
-        float* speed = new float;
-        *speed       = ax::random(90.0f, 180.0f);
-        bomb->setUserData(static_cast<void*>(speed));
-        bomb->setPosition(AXRANDOM_0_1() * _visibleSize.width, _visibleSize.height + bomb->getContentSize().height / 2);
-        this->addChild(bomb, 1);
-        _bombs.pushBack(bomb);
+        AXLOGW("Failed to write the round snapshot");
     }
 }
 
-void MainScene::initAudioNewEngine()
+// Rebuild the round the OS killed in the background, if there is one
+void MainScene::restoreSnapshot()
 {
-    if (ax::AudioEngine::lazyInit())
+    if (_stressTest || !_snapshot.load())
     {
-        _musicId = ax::AudioEngine::play2d("music.mp3");
-        ax::AudioEngine::setVolume(_musicId, 1);
-        ax::AudioEngine::setLoop(_musicId, true);
-        AXLOGD("Audio initialized successfully");
+        return;
     }
-    else
+    GameSnapshot::discard();
+
+    _round.restore(_snapshot);
+    syncRound();
+
+    AXLOGI("Restored a round with {} bombs and score {}", _snapshot.bombs.size(), _round.getScore());
+}
+
+void MainScene::explodeBombs(const ax::Vec2& touchLocation)
+{
+    _round.tap(touchLocation, [this](const ax::Vec2& position) { showExplosion(position); });
+    syncRound();
+}
+
+void MainScene::showExplosion(const ax::Vec2& position)
+{
+    SfxCache::getInstance()->play("bomb.mp3");
+    PERF_SCOPE(SystemTimings::System::Particles);
+    auto explosion = ParticlePack::getInstance()->create("explosion");
+    if (!explosion)
     {
-        printf("Error while initializing new audio engine.\n");
+        explosion = ax::ParticleSystemQuad::create("explosion.plist");
+    }
+    explosion->setAutoRemoveOnFinish(true);
+    explosion->setPosition(position);
+    this->addChild(explosion);
+}
+
+// Platform callbacks only record timestamped events; update() applies them once per tick
+void MainScene::initTouch()
+{
+    _touchListener               = ax::EventListenerTouchOneByOne::create();
+    _touchListener->onTouchBegan = [this](ax::Touch* touch, ax::Event* event) {
+        ax::Vec2 location = touch->getLocation();
+        _inputQueue.push(InputEvent::Type::TouchBegan, location.x, location.y);
+        return true;
+    };
+    _touchListener->onTouchMoved = [this](ax::Touch* touch, ax::Event* event) {
+        ax::Vec2 location = touch->getLocation();
+        _inputQueue.push(InputEvent::Type::TouchMoved, location.x, location.y);
+    };
+    _touchListener->onTouchEnded = [this](ax::Touch* touch, ax::Event* event) {
+        ax::Vec2 location = touch->getLocation();
+        _inputQueue.push(InputEvent::Type::TouchEnded, location.x, location.y);
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(_touchListener, this);
+}
+
+void MainScene::initAccelerometer()
+{
+    ax::Device::setAccelerometerEnabled(true);
+    _accelerationListener =
+        ax::EventListenerAcceleration::create([this](ax::Acceleration* acceleration, ax::Event* event) {
+        _inputQueue.push(InputEvent::Type::Acceleration, static_cast<float>(acceleration->x),
+                         static_cast<float>(acceleration->y));
+    });
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(_accelerationListener, this);
+}
+
+void MainScene::handleInput(const InputEvent& event)
+{
+    auto latency = LatencyTracker::getInstance();
+    switch (event.type)
+    {
+    case InputEvent::Type::TouchBegan:
+        explodeBombs(ax::Vec2(event.x, event.y));
+        latency->inputApplied(LatencyTracker::Source::Tap, event.timestamp);
+        break;
+    case InputEvent::Type::TouchMoved:
+        _round.dragPlayer(ax::Vec2(event.x, event.y));
+        _sprPlayer->setPosition(_round.getPlayerPosition());
+        latency->inputApplied(LatencyTracker::Source::Drag, event.timestamp);
+        break;
+    case InputEvent::Type::Acceleration:
+        _round.tiltPlayer(event.x);
+        _sprPlayer->setPosition(_round.getPlayerPosition());
+        latency->inputApplied(LatencyTracker::Source::Tilt, event.timestamp);
+        break;
+    case InputEvent::Type::KeyReleased:
+        onKeyPressed(static_cast<ax::EventKeyboard::KeyCode>(event.code), nullptr);
+        break;
+    default:
+        break;
+    }
+}
+
+void MainScene::onCollision()
+{
+    _gameState = GameState::end;
+
+    // Keep the music stream open so a restart only has to rewind it
+    _music.pause();
+    if (_muteItem->isVisible())
+    {
+        SfxCache::getInstance()->play("uh.mp3");
+    }
+
+    ax::UserDefault::getInstance()->setIntegerForKey("score", _round.getScore());
+    LeaderboardClient::getInstance()->submit(_round.getScore());
+    _director->pushScene(ax::TransitionFlipX::create(1.0, GameOver::createScene()));
+}
+
+// Scripted player for unattended runs. It feeds the input queue like a real player would,
+// so the whole input path is exercised; the batch simulator's bot makes the same moves.
+Timeline::Task MainScene::autoplay(Timeline& timeline)
+{
+    for (;;)
+    {
+        co_await timeline.seconds(AUTOPLAY_INTERVAL);
+        if (_gameState != GameState::update)
+        {
+            continue;
+        }
+
+        // With the threaded sim the round belongs to its thread, which suggests the move with every frame
+        GameRound::BotMove move = _sim ? _sim->latest().botMove : _round.suggestBotMove();
+        if (move.tap)
+        {
+            _inputQueue.push(InputEvent::Type::TouchBegan, move.tapAt.x, move.tapAt.y);
+            _inputQueue.push(InputEvent::Type::TouchEnded, move.tapAt.x, move.tapAt.y);
+        }
+        if (move.drag)
+        {
+            _inputQueue.push(InputEvent::Type::TouchMoved, move.dragTo.x, move.dragTo.y);
+        }
     }
-    ax::AudioEngine::preload("uh.mp3");
+}
+
+void MainScene::initAudioNewEngine()
+{
+    // AppDelegate started opening the device; the round starts silent and the music fades in once it is up
+    AudioStartup::getInstance()->whenReady(this, [this] {
+        // The track is decoded on the stream's own thread, a chunk at a time
+        if (_music.open("music.mp3"))
+        {
+            _music.setLoop(true);
+            _music.fadeIn(MUSIC_FADE_IN_SECONDS);
+            if (_gameState != GameState::end)
+            {
+                _music.play();
+            }
+        }
+    });
 }
 
 void MainScene::initMuteButton()
@@ -226,10 +628,72 @@ void MainScene::initMuteButton()
     this->addChild(menu, 2);
 }
 
+// Input-to-present latency next to the FPS stats, refreshed once per second
+void MainScene::initLatencyOverlay()
+{
+    if (!_director->isStatsDisplay())
+    {
+        return;
+    }
+
+    auto label = ax::Label::createWithTTF(LatencyTracker::getInstance()->getSummary(), "fonts/arial.ttf", 24);
+    label->setAnchorPoint(ax::Vec2(0.0f, 1.0f));
+    label->setPosition(ax::Vec2(0.0f, _visibleSize.height));
+    this->addChild(label, 3);
+
+    schedule(
+        [label](float) {
+            label->setString(LatencyTracker::getInstance()->getSummary() +
+                             ax::StringUtils::format("\nstatic cache: %.1f Mpx fill saved",
+                                                     StaticLayer::getTotalPixelsSaved() / 1.0e6));
+        },
+        1.0f, "latencyOverlay");
+}
+
+// The scene's side of the debug overlay: entity and pool counts, and the switches only it can flip
+void MainScene::initInspectorSection()
+{
+#if HAPPY_INSPECTOR
+    Inspector::getInstance()->addSection(this, "MainScene", [this] {
+        size_t explosions = 0;
+        for (auto child : getChildren())
+        {
+            if (dynamic_cast<ax::ParticleSystem*>(child))
+            {
+                ++explosions;
+            }
+        }
+
+        ImGui::Text("bombs: %zu live, %zu slots", _round.getBombCount(), _round.getBombSlotCount());
+        ImGui::Text("bomb instances: %zu, %s", _bombRenderer->size(),
+                    _bombRenderer->isMotionEnabled() ? "moved on the GPU" : "written every frame");
+        ImGui::Text("explosions: %zu", explosions);
+        ImGui::Text("input queue: %zu queued, %u dropped", _inputQueue.size(), _inputQueue.getDroppedCount());
+        if (_stressTest)
+        {
+            ImGui::Text("stress target: %u bombs", _stressTest->getTargetBombs());
+        }
+
+        // The threaded sim hands over fresh bombs every frame, so it always draws them from the CPU
+        if (!_sim)
+        {
+            bool gpuMotion = _bombRenderer->isMotionEnabled();
+            if (ImGui::Checkbox("GPU bomb motion", &gpuMotion))
+            {
+                _bombRenderer->setMotionEnabled(gpuMotion);
+                _round.setTrackBombChanges(_bombRenderer->isMotionEnabled());
+                _syncedBombRevision = ~0u;
+                syncRound();
+            }
+        }
+    });
+#endif
+}
+
 void MainScene::muteCallback(ax::Object* pSender)
 {
 
-    ax::AudioEngine::setVolume(_musicId, _unmuteItem->isVisible());
+    _music.setVolume(_unmuteItem->isVisible());
 
     _muteItem->setVisible(!_muteItem->isVisible());
     _unmuteItem->setVisible(!_muteItem->isVisible());
@@ -242,10 +706,12 @@ void MainScene::pauseCallback(ax::Object* pSender)
 
 void MainScene::initBackButtonListener()
 {
-    auto listener           = ax::EventListenerKeyboard::create();
-    listener->onKeyPressed  = [=](ax::EventKeyboard::KeyCode keyCode, ax::Event* event) {};
-    listener->onKeyReleased = AX_CALLBACK_2(MainScene::onKeyPressed, this);
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+    _keyboardListener                = ax::EventListenerKeyboard::create();
+    _keyboardListener->onKeyPressed  = [=](ax::EventKeyboard::KeyCode keyCode, ax::Event* event) {};
+    _keyboardListener->onKeyReleased = [this](ax::EventKeyboard::KeyCode keyCode, ax::Event* event) {
+        _inputQueue.push(InputEvent::Type::KeyReleased, 0.0f, 0.0f, static_cast<int32_t>(keyCode));
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(_keyboardListener, this);
 }
 
 void MainScene::onKeyPressed(ax::EventKeyboard::KeyCode keyCode, ax::Event* event)
@@ -263,49 +729,32 @@ void MainScene::menuCloseCallback(ax::Object* sender)
 
 void MainScene::update(float delta)
 {
-    switch (_gameState)
-    {
-    case GameState::init:
-        _gameState = GameState::update;
-        break;
+    ALLOC_SCOPE("MainScene::update");
+    PERF_SCOPE(SystemTimings::System::Update);
 
-    case GameState::update:
+    // While the sim thread runs it is the queue's consumer
+    if (!_sim || !_sim->isRunning())
     {
-        ax::Vector<ax::Sprite*> toErase;
-
-        for (auto bomb : _bombs)
-        {
-            bomb->setPositionY(bomb->getPositionY() - (static_cast<float*>(bomb->getUserData())[0]) * delta);
-            if (bomb->getBoundingBox().intersectsRect(_sprPlayer->getBoundingBox()))
-            {
-                onCollision();
-            }
-            if (bomb->getPositionY() < -bomb->getContentSize().height / 2)
-            {
-                toErase.pushBack(bomb);
-                this->removeChild(bomb);
-            }
-        }
-
-        for (auto bomb : toErase)
-        {
-            _bombs.eraseObject(bomb);
-        }
-
-        break;
-    }
+        _inputQueue.drain([this](const InputEvent& event) { handleInput(event); });
     }
+
+    // The round and the autoplay bot are scripts on the scene's timeline; see playRound()
+    _timeline.advance(delta);
 }
 
 MainScene::MainScene()
     : _gameState(GameState::init)
-    , _score(0)
-    , _musicId(-1)
+    , _backgroundListener(nullptr)
+    , _foregroundListener(nullptr)
+    , _tierListener(nullptr)
     , _sprPlayer(nullptr)
+    , _bombRenderer(nullptr)
+    , _syncedBombRevision(~0u)
     , _director(nullptr)
+    , _config(nullptr)
     , _touchListener(nullptr)
     , _keyboardListener(nullptr)
-    , _mouseListener(nullptr)
+    , _accelerationListener(nullptr)
     , _muteItem(nullptr)
     , _unmuteItem(nullptr)
 {
@@ -314,16 +763,13 @@ MainScene::MainScene()
 MainScene::~MainScene()
 {
     AXLOGD("Freeing MainScene resources.");
-    if (_touchListener)
-        _eventDispatcher->removeEventListener(_touchListener);
-    if (_keyboardListener)
-        _eventDispatcher->removeEventListener(_keyboardListener);
-    if (_mouseListener)
-        _eventDispatcher->removeEventListener(_mouseListener);
-
-    // Cleanup bomb user data
-    for (auto bomb : _bombs)
-    {
-        delete static_cast<float*>(bomb->getUserData());
-    }
+    // Scene graph priority listeners are removed together with this node in cleanup()
+    auto dispatcher = ax::Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_backgroundListener);
+    dispatcher->removeEventListener(_foregroundListener);
+    dispatcher->removeEventListener(_tierListener);
+    AudioStartup::getInstance()->cancel(this);
+#if HAPPY_INSPECTOR
+    Inspector::getInstance()->removeSections(this);
+#endif
 }
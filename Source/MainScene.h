@@ -1,6 +1,17 @@
 #pragma once
 
 #include "axmol/axmol.h"
+#include "GameConfig.h"
+#include "GameRound.h"
+#include "GameSnapshot.h"
+#include "InputQueue.h"
+#include "MusicStream.h"
+#include "SimThread.h"
+#include "SpriteBatchRenderer.h"
+#include "StressTest.h"
+#include "Timeline.h"
+
+#include <memory>
 
 class MainScene : public ax::Node
 {
@@ -18,19 +29,9 @@ public:
     static ax::Scene* createScene();
     bool init() override;
     void onEnter() override;
+    void onExit() override;
     void update(float delta) override;
 
-    // touch
-    void onTouchesBegan(const std::vector<ax::Touch*>& touches, ax::Event* event);
-    void onTouchesMoved(const std::vector<ax::Touch*>& touches, ax::Event* event);
-    void onTouchesEnded(const std::vector<ax::Touch*>& touches, ax::Event* event);
-
-    // mouse
-    bool onMouseDown(ax::Event* event);
-    bool onMouseUp(ax::Event* event);
-    bool onMouseMove(ax::Event* event);
-    bool onMouseScroll(ax::Event* event);
-
     // Keyboard
     void onKeyPressed(ax::EventKeyboard::KeyCode code, ax::Event* event);
     void onKeyReleased(ax::EventKeyboard::KeyCode code, ax::Event* event);
@@ -43,30 +44,55 @@ public:
 
 private:
     GameState _gameState;
-    ax::EventListenerTouchAllAtOnce* _touchListener;
+    ax::EventListenerTouchOneByOne* _touchListener;
     ax::EventListenerKeyboard* _keyboardListener;
-    ax::EventListenerMouse* _mouseListener;
+    ax::EventListenerAcceleration* _accelerationListener;
+    InputQueue _inputQueue;
     ax::Director* _director;
+    GameConfig* _config;
+    std::unique_ptr<StressTest> _stressTest;
 
 	ax::Size _visibleSize;
     ax::Sprite* _sprPlayer;
-    ax::Vector<ax::Sprite*> _bombs;
+
+    SpriteBatchRenderer* _bombRenderer;  // mirrors the round's bombs, drawn in one batch
+    uint32_t _syncedBombRevision;        // the round's bomb revision the renderer holds
     ax::MenuItemImage* _muteItem;
     ax::MenuItemImage* _unmuteItem;
-    int _score;
-    int _musicId;
+    GameRound _round;
+    GameSnapshot _snapshot;
+    std::vector<uint8_t> _snapshotBuffer;
+    ax::EventListenerCustom* _backgroundListener;
+    ax::EventListenerCustom* _foregroundListener;
+    ax::EventListenerCustom* _tierListener;
+    MusicStream _music;
+    Timeline _timeline;  // the scene's scripts: the round itself and the autoplay bot
+    std::unique_ptr<SimThread> _sim;  // threaded-sim only; declared last so it stops before the round goes
     void pauseCallback(ax::Object* pSender);
     void muteCallback(ax::Object* pSender);
     void onCollision();
+    void resetRound();
     void initTouch();
-    void movePlayerByTouch(ax::Touch* touch, ax::Event* event);
-    bool explodeBombs(ax::Touch* touch, ax::Event* event);
-    void movePlayerIfPossible(float newX);
-    void movePlayerByAccelerometer(ax::Acceleration* acceleration, ax::Event* event);
+    void handleInput(const InputEvent& event);
+    void explodeBombs(const ax::Vec2& touchLocation);
     void initAccelerometer();
     void initBackButtonListener();
-    void updateScore(float dt);
-    void addBombs(float dt);
+    Timeline::Task playRound(Timeline& timeline);
+    Timeline::Task followSim(Timeline& timeline);
+    void initSimThread();
+    void resumeSim();
+    void showFrame(const RoundFrame& frame);
+    void onSimEvent(const SimThread::Event& event);
+    void showExplosion(const ax::Vec2& position);
+    Timeline::Task autoplay(Timeline& timeline);
+    void syncRound();
     void initAudioNewEngine();
     void initMuteButton();
+    void initLatencyOverlay();
+    void initInspectorSection();
+    void initSnapshotListeners();
+    void saveSnapshot();
+    void restoreSnapshot();
+    void runPlayerAnimation();
+    void onImageTierChanged();
 };
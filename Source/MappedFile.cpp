@@ -0,0 +1,109 @@
+#include "MappedFile.h"
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
+#    include <windows.h>
+#elif AX_TARGET_PLATFORM == AX_PLATFORM_LINUX || AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID || \
+    AX_TARGET_PLATFORM == AX_PLATFORM_MAC || AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+#    define MAPPED_FILE_POSIX 1
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(std::string_view fullPath)
+{
+    close();
+    if (fullPath.empty())
+    {
+        return false;
+    }
+
+    std::string path(fullPath);
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
+    int wideLength = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring widePath(wideLength, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, widePath.data(), wideLength);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        {
+            HANDLE handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (handle)
+            {
+                _mapping = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+                if (_mapping)
+                {
+                    _mappingHandle = handle;
+                    _size          = static_cast<size_t>(fileSize.QuadPart);
+                }
+                else
+                {
+                    CloseHandle(handle);
+                }
+            }
+        }
+        CloseHandle(file);
+    }
+#elif defined(MAPPED_FILE_POSIX)
+    // Android asset paths are relative to the APK and cannot be mapped directly
+    int fd = path.front() == '/' ? ::open(path.c_str(), O_RDONLY) : -1;
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                _mapping = mapping;
+                _size    = static_cast<size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+    }
+#endif
+
+    if (_mapping)
+    {
+        _data = static_cast<const uint8_t*>(_mapping);
+        return true;
+    }
+
+    _fallback = ax::FileUtils::getInstance()->getDataFromFile(path);
+    if (_fallback.isNull())
+    {
+        return false;
+    }
+    _data = _fallback.getBytes();
+    _size = static_cast<size_t>(_fallback.getSize());
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (_mapping)
+    {
+#if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
+        UnmapViewOfFile(_mapping);
+        CloseHandle(_mappingHandle);
+        _mappingHandle = nullptr;
+#elif defined(MAPPED_FILE_POSIX)
+        munmap(_mapping, _size);
+#endif
+        _mapping = nullptr;
+    }
+    _fallback.clear();
+    _data = nullptr;
+    _size = 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "axmol/axmol.h"
+
+#include <string_view>
+
+/**
+@brief  Read-only memory mapping of a whole file.
+
+Falls back to reading the file into memory when it cannot be mapped, e.g. when it
+lives inside the Android APK or on platforms without mmap.
+*/
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+    @brief  Map the file at `fullPath`, as returned by FileUtils::fullPathForFilename().
+    @return true    The contents are available through data() and size().
+    */
+    bool open(std::string_view fullPath);
+    void close();
+
+    const uint8_t* data() const { return _data; }
+    size_t size() const { return _size; }
+    bool isMapped() const { return _mapping != nullptr; }
+
+private:
+    const uint8_t* _data = nullptr;
+    size_t _size         = 0;
+    void* _mapping       = nullptr;
+#if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
+    void* _mappingHandle = nullptr;
+#endif
+    ax::Data _fallback;
+};
@@ -0,0 +1,181 @@
+#include "MemoryBudget.h"
+#include "FramePacer.h"
+
+#include <algorithm>
+
+namespace
+{
+// Also how often high-water marks are refreshed while the app draws. A sleeping FramePacer stops sampling too,
+// but then nothing is loaded either: whatever loads in the background keeps the pacer awake.
+constexpr float SAMPLE_INTERVAL = 1.0f;
+
+MemoryBudget* s_sharedMemoryBudget = nullptr;
+}  // namespace
+
+MemoryBudget* MemoryBudget::getInstance()
+{
+    if (!s_sharedMemoryBudget)
+    {
+        s_sharedMemoryBudget = new MemoryBudget();
+    }
+    return s_sharedMemoryBudget;
+}
+
+void MemoryBudget::destroyInstance()
+{
+    delete s_sharedMemoryBudget;
+    s_sharedMemoryBudget = nullptr;
+}
+
+const char* MemoryBudget::getClassName(AssetClass assetClass)
+{
+    switch (assetClass)
+    {
+    case AssetClass::StaticLayers:
+        return "static_layers";
+    case AssetClass::Particles:
+        return "particles";
+    case AssetClass::Fonts:
+        return "fonts";
+    case AssetClass::Audio:
+        return "audio";
+    case AssetClass::Textures:
+        return "textures";
+    default:
+        return "unknown";
+    }
+}
+
+MemoryBudget::MemoryBudget() : _budget(64 * 1024 * 1024), _totalHighWater(0), _purgeCount(0)
+{
+    ax::Director::getInstance()->getScheduler()->schedule([this](float) { sample(); }, this, SAMPLE_INTERVAL, false,
+                                                          "MemoryBudget.sample");
+}
+
+MemoryBudget::~MemoryBudget()
+{
+    ax::Director::getInstance()->getScheduler()->unscheduleAllForTarget(this);
+}
+
+void MemoryBudget::registerClass(AssetClass assetClass, Provider provider)
+{
+    _entries[index(assetClass)].provider = std::move(provider);
+}
+
+size_t MemoryBudget::sample()
+{
+    size_t total = 0;
+    for (auto& entry : _entries)
+    {
+        entry.resident  = entry.provider.measure ? entry.provider.measure() : 0;
+        entry.highWater = std::max(entry.highWater, entry.resident);
+        total += entry.resident;
+    }
+    _totalHighWater = std::max(_totalHighWater, total);
+    return total;
+}
+
+void MemoryBudget::purge(bool everything)
+{
+    size_t total = sample();
+    for (size_t i = 0; i < CLASS_COUNT; ++i)
+    {
+        auto& entry = _entries[i];
+        if (!everything && total <= _budget)
+        {
+            break;
+        }
+        if (!entry.provider.purge)
+        {
+            continue;
+        }
+
+        // Under pressure while playing, each class comes back when it is next used: sound effects and the particle
+        // pack reload on first request, layers, glyphs and textures when they are drawn or added again. Only
+        // background purges are reloaded ahead.
+        entry.provider.purge();
+        entry.purged = entry.purged || everything;
+
+        size_t before  = entry.resident;
+        entry.resident = entry.provider.measure ? entry.provider.measure() : 0;
+        total -= before - std::min(before, entry.resident);
+        AXLOGI("MemoryBudget: purged {}, {} KiB freed", getClassName(static_cast<AssetClass>(i)),
+               (before - std::min(before, entry.resident)) / 1024);
+    }
+    ++_purgeCount;
+}
+
+void MemoryBudget::onEnterBackground()
+{
+    // Sample first so the marks include what was resident while playing
+    sample();
+    purge(true);
+}
+
+void MemoryBudget::onLowMemory()
+{
+    AXLOGW("MemoryBudget: low memory, {} KiB resident, budget {} KiB", sample() / 1024, _budget / 1024);
+    purge(false);
+}
+
+void MemoryBudget::onEnterForeground()
+{
+    reloadNext();
+}
+
+// One class per frame, so coming back does not stall on a single long frame
+void MemoryBudget::reloadNext()
+{
+    for (size_t i = 0; i < CLASS_COUNT; ++i)
+    {
+        auto& entry = _entries[i];
+        if (!entry.purged)
+        {
+            continue;
+        }
+
+        entry.purged = false;
+        if (entry.provider.reload)
+        {
+            entry.provider.reload();
+        }
+        ax::Director::getInstance()->getScheduler()->schedule([this](float) { reloadNext(); }, this, 0.0f, 0, 0.0f,
+                                                              false, "MemoryBudget.reload");
+        FramePacer::getInstance()->setBusy(this, true);
+        return;
+    }
+    FramePacer::getInstance()->setBusy(this, false);
+}
+
+std::string MemoryBudget::getReport()
+{
+    size_t total = sample();
+
+    std::string report;
+    report += ax::StringUtils::format("resident_kib: %zu\n", total / 1024);
+    report += ax::StringUtils::format("high_water_kib: %zu\n", _totalHighWater / 1024);
+    report += ax::StringUtils::format("budget_kib: %zu\n", _budget / 1024);
+    report += ax::StringUtils::format("purges: %u\n", _purgeCount);
+    report += "\nclass resident_kib high_water_kib\n";
+    for (size_t i = 0; i < CLASS_COUNT; ++i)
+    {
+        const auto& entry = _entries[i];
+        const char* name  = getClassName(static_cast<AssetClass>(i));
+        if (!entry.provider.measure)
+        {
+            report += ax::StringUtils::format("%s untracked\n", name);
+            continue;
+        }
+        report += ax::StringUtils::format("%s %zu %zu\n", name, entry.resident / 1024, entry.highWater / 1024);
+    }
+    return report;
+}
+
+bool MemoryBudget::writeReport()
+{
+    auto fileUtils   = ax::FileUtils::getInstance();
+    std::string path = fileUtils->getWritablePath() + "memory_report.txt";
+    std::string text = getReport();
+    AXLOGI("Memory report written to {}\n{}", path, text);
+    return fileUtils->writeStringToFile(text, path);
+}
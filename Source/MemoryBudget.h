@@ -0,0 +1,91 @@
+#pragma once
+
+#include "axmol/axmol.h"
+
+#include <array>
+#include <functional>
+#include <string>
+
+/**
+@brief  Tracks resident bytes per asset class and evicts caches under memory pressure.
+
+Each class is registered by whoever owns the memory, with callbacks to measure
+it, purge it and reload it. Purging walks the classes in enum order, cheapest to
+rebuild first: everything when the app is backgrounded, and on a low-memory
+signal only until the total is back under the budget. Coming back to the
+foreground reloads the purged classes one per frame (textures asynchronously).
+A low-memory purge reloads nothing ahead: each owner rebuilds what was purged
+the first time it is requested again, as does anything touched before the
+foreground reload reaches it.
+
+High-water marks are kept per class and written to memory_report.txt.
+*/
+class MemoryBudget
+{
+public:
+    // Eviction order
+    enum class AssetClass
+    {
+        StaticLayers,  // render-target caches, rebuilt from their children
+        Particles,     // particle pack textures, re-uploaded from the mapped pack
+        Fonts,         // glyph atlases, regenerated by labels
+        Audio,         // decoded sound effects, remapped from the PCM cache
+        Textures,      // TextureCache entries no node uses any more
+        Count
+    };
+
+    struct Provider
+    {
+        std::function<size_t()> measure;  // resident bytes; may be null when the class cannot be measured
+        std::function<void()> purge;
+        std::function<void()> reload;  // may be null when the owner rebuilds lazily
+    };
+
+    static MemoryBudget* getInstance();
+    static void destroyInstance();
+
+    static const char* getClassName(AssetClass assetClass);
+
+    void registerClass(AssetClass assetClass, Provider provider);
+
+    /** Total the low-memory purge tries to get under. Defaults to 64 MiB. */
+    void setBudget(size_t bytes) { _budget = bytes; }
+
+    /** Measure every class and update the high-water marks. @return total resident bytes. */
+    size_t sample();
+
+    void onEnterBackground();
+    void onEnterForeground();
+    void onLowMemory();
+
+    size_t getResidentBytes(AssetClass assetClass) const { return _entries[index(assetClass)].resident; }
+    size_t getHighWater(AssetClass assetClass) const { return _entries[index(assetClass)].highWater; }
+
+    std::string getReport();
+
+    /** Write getReport() to memory_report.txt in the writable path. */
+    bool writeReport();
+
+    ~MemoryBudget();
+
+private:
+    struct Entry
+    {
+        Provider provider;
+        size_t resident  = 0;
+        size_t highWater = 0;
+        bool purged      = false;
+    };
+
+    static constexpr size_t CLASS_COUNT = static_cast<size_t>(AssetClass::Count);
+    static size_t index(AssetClass assetClass) { return static_cast<size_t>(assetClass); }
+
+    MemoryBudget();
+    void purge(bool everything);
+    void reloadNext();
+
+    std::array<Entry, CLASS_COUNT> _entries;
+    size_t _budget;
+    size_t _totalHighWater;
+    uint32_t _purgeCount;
+};
@@ -0,0 +1,270 @@
+#include "MusicStream.h"
+#include "SystemTimings.h"
+#include "axmol/audio/AudioEngine.h"
+
+#if AX_TARGET_PLATFORM != AX_PLATFORM_WASM
+#    include "axmol/audio/AudioDecoder.h"
+#    include "axmol/audio/AudioDecoderManager.h"
+#    include "axmol/audio/alconfig.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+// OpenAL buffers kept queued; with the ring this is under a second of audio ahead
+constexpr int AL_BUFFER_COUNT = 4;
+
+// How long the stream thread sleeps when there is nothing to decode or queue
+constexpr auto IDLE_WAIT = std::chrono::milliseconds(10);
+}  // namespace
+
+std::atomic<bool> MusicStream::s_suspended{false};
+
+MusicStream::MusicStream()
+    : _generation(0)
+    , _volume(1.0f)
+    , _fadeSeconds(0.0f)
+    , _playing(false)
+    , _loop(true)
+    , _quit(false)
+    , _fallbackAudioId(ax::AudioEngine::INVALID_AUDIO_ID)
+{}
+
+MusicStream::~MusicStream()
+{
+    _quit = true;
+    wake();
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+    if (_fallbackAudioId != ax::AudioEngine::INVALID_AUDIO_ID)
+    {
+        ax::AudioEngine::stop(_fallbackAudioId);
+    }
+}
+
+bool MusicStream::open(std::string_view filename)
+{
+    _fullPath = ax::FileUtils::getInstance()->fullPathForFilename(filename);
+    if (_fullPath.empty())
+    {
+        return false;
+    }
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_WASM
+    _fallbackAudioId = ax::AudioEngine::play2d(_fullPath, _loop, _volume);
+    ax::AudioEngine::pause(_fallbackAudioId);
+    return _fallbackAudioId != ax::AudioEngine::INVALID_AUDIO_ID;
+#else
+    _thread = std::thread(&MusicStream::run, this);
+    return true;
+#endif
+}
+
+void MusicStream::play()
+{
+    _playing = true;
+    if (_fallbackAudioId != ax::AudioEngine::INVALID_AUDIO_ID)
+    {
+        ax::AudioEngine::resume(_fallbackAudioId);
+    }
+    wake();
+}
+
+void MusicStream::pause()
+{
+    _playing = false;
+    if (_fallbackAudioId != ax::AudioEngine::INVALID_AUDIO_ID)
+    {
+        ax::AudioEngine::pause(_fallbackAudioId);
+    }
+    wake();
+}
+
+void MusicStream::rewind()
+{
+    ++_generation;
+    if (_fallbackAudioId != ax::AudioEngine::INVALID_AUDIO_ID)
+    {
+        ax::AudioEngine::setCurrentTime(_fallbackAudioId, 0.0f);
+    }
+    wake();
+}
+
+void MusicStream::setVolume(float volume)
+{
+    _volume = volume;
+    if (_fallbackAudioId != ax::AudioEngine::INVALID_AUDIO_ID)
+    {
+        ax::AudioEngine::setVolume(_fallbackAudioId, volume);
+    }
+    wake();
+}
+
+void MusicStream::fadeIn(float seconds)
+{
+    _fadeSeconds = seconds;
+    wake();
+}
+
+void MusicStream::setLoop(bool loop)
+{
+    _loop = loop;
+    if (_fallbackAudioId != ax::AudioEngine::INVALID_AUDIO_ID)
+    {
+        ax::AudioEngine::setLoop(_fallbackAudioId, loop);
+    }
+}
+
+void MusicStream::setAllSuspended(bool suspended)
+{
+    s_suspended = suspended;
+}
+
+void MusicStream::wake()
+{
+    {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+    }
+    _wakeCondition.notify_one();
+}
+
+void MusicStream::run()
+{
+#if AX_TARGET_PLATFORM != AX_PLATFORM_WASM
+    ax::AudioDecoder* decoder = ax::AudioDecoderManager::createDecoder(_fullPath);
+    if (!decoder || !decoder->open(_fullPath) || decoder->getChannelCount() > 2)
+    {
+        AXLOGE("MusicStream: cannot stream {}", _fullPath);
+        ax::AudioDecoderManager::destroyDecoder(decoder);
+        return;
+    }
+
+    const uint32_t bytesPerFrame  = decoder->getBytesPerFrame();
+    const uint32_t framesPerChunk = CHUNK_BYTES / bytesPerFrame;
+    const ALenum format           = decoder->getChannelCount() == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+    const ALsizei sampleRate      = static_cast<ALsizei>(decoder->getSampleRate());
+
+    ALuint source;
+    ALuint freeBuffers[AL_BUFFER_COUNT];
+    int freeCount = AL_BUFFER_COUNT;
+    alGenSources(1, &source);
+    alGenBuffers(AL_BUFFER_COUNT, freeBuffers);
+
+    Chunk chunk;
+    uint32_t generation = _generation;
+    bool ended          = false;
+    float fadeDuration  = 0.0f;
+    auto fadeStart      = std::chrono::steady_clock::now();
+    while (!_quit)
+    {
+        if (uint32_t requested = _generation; requested != generation)
+        {
+            // Stopping marks every queued buffer processed, so all of them can be unqueued
+            alSourceStop(source);
+            ALint queued = 0;
+            alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+            while (queued-- > 0)
+            {
+                alSourceUnqueueBuffers(source, 1, &freeBuffers[freeCount++]);
+            }
+            while (_ring.pop(chunk))
+            {
+            }
+            decoder->seek(0);
+            ended      = false;
+            generation = requested;
+        }
+
+        // Decode ahead until the ring is full. The loop point is stitched inside a chunk.
+        while (!ended && _ring.size() < _ring.capacity())
+        {
+            PERF_SCOPE(SystemTimings::System::Audio);
+            chunk.bytes  = 0;
+            bool rewound = false;
+            while (chunk.bytes < framesPerChunk * bytesPerFrame)
+            {
+                uint32_t frames = decoder->read(framesPerChunk - chunk.bytes / bytesPerFrame, chunk.pcm + chunk.bytes);
+                if (frames > 0)
+                {
+                    chunk.bytes += frames * bytesPerFrame;
+                    rewound = false;
+                }
+                else if (!rewound && _loop && decoder->seek(0))
+                {
+                    rewound = true;
+                }
+                else
+                {
+                    ended = true;
+                    break;
+                }
+            }
+            if (chunk.bytes > 0)
+            {
+                _ring.push(chunk);
+            }
+        }
+
+        ALint processed = 0;
+        alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+        while (processed-- > 0)
+        {
+            alSourceUnqueueBuffers(source, 1, &freeBuffers[freeCount++]);
+        }
+        while (freeCount > 0 && _ring.pop(chunk))
+        {
+            ALuint buffer = freeBuffers[--freeCount];
+            alBufferData(buffer, format, chunk.pcm, static_cast<ALsizei>(chunk.bytes), sampleRate);
+            alSourceQueueBuffers(source, 1, &buffer);
+        }
+
+        // Stepped at most IDLE_WAIT apart, which is fine-grained enough for a fade
+        float gain = _volume;
+        if (float fade = _fadeSeconds.exchange(0.0f); fade > 0.0f)
+        {
+            fadeDuration = fade;
+            fadeStart    = std::chrono::steady_clock::now();
+        }
+        if (fadeDuration > 0.0f)
+        {
+            float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - fadeStart).count();
+            gain *= std::min(elapsed / fadeDuration, 1.0f);
+            fadeDuration = elapsed < fadeDuration ? fadeDuration : 0.0f;
+        }
+        alSourcef(source, AL_GAIN, gain);
+
+        // Also restarts the source after an underrun left it stopped
+        ALint state  = AL_STOPPED;
+        ALint queued = 0;
+        alGetSourcei(source, AL_SOURCE_STATE, &state);
+        alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+        bool audible = _playing && !s_suspended;
+        if (audible && state != AL_PLAYING && queued > 0)
+        {
+            alSourcePlay(source);
+        }
+        else if (!audible && state == AL_PLAYING)
+        {
+            alSourcePause(source);
+        }
+
+        std::unique_lock<std::mutex> lock(_wakeMutex);
+        _wakeCondition.wait_for(lock, IDLE_WAIT);
+    }
+
+    alSourceStop(source);
+    ALint queued = 0;
+    alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+    while (queued-- > 0)
+    {
+        alSourceUnqueueBuffers(source, 1, &freeBuffers[freeCount++]);
+    }
+    alDeleteSources(1, &source);
+    alDeleteBuffers(freeCount, freeBuffers);
+    ax::AudioDecoderManager::destroyDecoder(decoder);
+#endif
+}
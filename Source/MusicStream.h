@@ -0,0 +1,76 @@
+#pragma once
+
+#include "axmol/axmol.h"
+#include "SpscRing.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+@brief  Streams one long music track with a fixed amount of resident memory.
+
+A background thread opens and decodes the track in small chunks into a bounded
+ring, and keeps a few OpenAL buffers queued from it. Loops are stitched in the
+decoder (it seeks to frame 0 and keeps filling the same chunk), so there is no
+gap or restart at the loop point. Neither opening the stream nor rewinding it
+decodes anything on the calling thread.
+
+Controls only set the desired state; the stream thread applies it within a few
+milliseconds. Where threads or OpenAL are unavailable (web builds) the track is
+played through AudioEngine instead, with the same interface.
+*/
+class MusicStream
+{
+public:
+    MusicStream();
+    ~MusicStream();
+
+    /** Start streaming `filename` (paused until play()). @return false if the file does not exist. */
+    bool open(std::string_view filename);
+
+    void play();
+    void pause();
+
+    /** Restart from the beginning; queued audio is dropped. */
+    void rewind();
+
+    void setVolume(float volume);
+    void setLoop(bool loop);
+
+    /** Ramp from silence up to the volume over `seconds`, starting now. Web builds start at full volume. */
+    void fadeIn(float seconds);
+
+    /** Pause every stream while the app is in the background, without changing their own play state. */
+    static void setAllSuspended(bool suspended);
+
+private:
+    // 4096 stereo 16-bit frames, about 93 ms at 44.1 kHz
+    static constexpr size_t CHUNK_BYTES = 16 * 1024;
+
+    struct Chunk
+    {
+        uint32_t bytes;
+        char pcm[CHUNK_BYTES];
+    };
+
+    void run();
+    void wake();
+
+    static std::atomic<bool> s_suspended;
+
+    std::string _fullPath;
+    std::thread _thread;
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeCondition;
+    SpscRing<Chunk, 8> _ring;           // decoded audio ahead of the OpenAL queue, stream thread only
+    std::atomic<uint32_t> _generation;  // bumped by rewind()
+    std::atomic<float> _volume;
+    std::atomic<float> _fadeSeconds;  // set by fadeIn(), taken by the stream thread
+    std::atomic<bool> _playing;
+    std::atomic<bool> _loop;
+    std::atomic<bool> _quit;
+    int _fallbackAudioId;  // AudioEngine id when not streaming
+};
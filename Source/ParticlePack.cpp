@@ -0,0 +1,216 @@
+#include "ParticlePack.h"
+
+#include <cstring>
+
+namespace
+{
+struct PackHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t emitterCount;
+    uint32_t textureCount;
+};
+
+struct PackTexture
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t offset;
+    uint32_t size;
+};
+
+constexpr uint32_t PACK_VERSION = 1;
+
+ParticlePack* s_sharedParticlePack = nullptr;
+}  // namespace
+
+ParticlePack* ParticlePack::getInstance()
+{
+    if (!s_sharedParticlePack)
+    {
+        s_sharedParticlePack = new ParticlePack();
+    }
+    return s_sharedParticlePack;
+}
+
+void ParticlePack::destroyInstance()
+{
+    delete s_sharedParticlePack;
+    s_sharedParticlePack = nullptr;
+}
+
+ParticlePack::~ParticlePack()
+{
+    unload();
+}
+
+bool ParticlePack::load(std::string_view filename)
+{
+    unload();
+    _filename = filename;
+    _purged   = false;
+
+    auto fullPath = ax::FileUtils::getInstance()->fullPathForFilename(filename);
+    if (!_file.open(fullPath))
+    {
+        AXLOGD("Particle pack {} not found, falling back to plists", filename);
+        return false;
+    }
+
+    auto header = reinterpret_cast<const PackHeader*>(_file.data());
+    if (_file.size() < sizeof(PackHeader) || memcmp(header->magic, "HPAK", 4) != 0 ||
+        header->version != PACK_VERSION ||
+        _file.size() < sizeof(PackHeader) + size_t(header->emitterCount) * sizeof(ParticleDescriptor) +
+                           size_t(header->textureCount) * sizeof(PackTexture))
+    {
+        AXLOGW("Ignoring malformed particle pack {}", fullPath);
+        _file.close();
+        return false;
+    }
+
+    _emitters     = reinterpret_cast<const ParticleDescriptor*>(_file.data() + sizeof(PackHeader));
+    _emitterCount = header->emitterCount;
+
+    auto textures = reinterpret_cast<const PackTexture*>(_emitters + _emitterCount);
+    for (uint32_t i = 0; i < header->textureCount; ++i)
+    {
+        const auto& entry = textures[i];
+        auto texture      = new ax::Texture2D();
+        if (size_t(entry.offset) + entry.size > _file.size() ||
+            !texture->initWithData(_file.data() + entry.offset, entry.size, ax::backend::PixelFormat::RGBA8,
+                                   entry.width, entry.height, true))
+        {
+            AXLOGW("Failed to upload texture {} of particle pack {}", i, fullPath);
+            AX_SAFE_RELEASE_NULL(texture);
+        }
+        _textures.push_back(texture);
+    }
+
+    return true;
+}
+
+void ParticlePack::unload()
+{
+    for (auto texture : _textures)
+    {
+        AX_SAFE_RELEASE(texture);
+    }
+    _textures.clear();
+    _emitters     = nullptr;
+    _emitterCount = 0;
+    _file.close();
+}
+
+void ParticlePack::purge()
+{
+    unload();
+    _purged = true;
+}
+
+bool ParticlePack::reload()
+{
+    if (!_purged)
+    {
+        return _emitterCount > 0;
+    }
+    return !_filename.empty() && load(std::string(_filename));
+}
+
+size_t ParticlePack::getResidentBytes() const
+{
+    size_t bytes = _file.isMapped() ? 0 : _file.size();
+    for (auto texture : _textures)
+    {
+        if (texture)
+        {
+            bytes += static_cast<size_t>(texture->getPixelsWide()) * texture->getPixelsHigh() * 4;
+        }
+    }
+    return bytes;
+}
+
+ax::ParticleSystemQuad* ParticlePack::create(std::string_view name)
+{
+    // Mapping the pack again costs far less than the plist fallback would on every explosion
+    if (_purged)
+    {
+        reload();
+    }
+
+    for (uint32_t i = 0; i < _emitterCount; ++i)
+    {
+        const auto& d = _emitters[i];
+        if (name != d.name)
+        {
+            continue;
+        }
+
+        ax::Texture2D* texture = nullptr;
+        if (d.texture != ParticleDescriptor::NO_TEXTURE)
+        {
+            texture = d.texture < _textures.size() ? _textures[d.texture] : nullptr;
+        }
+        else if (d.textureFile[0])
+        {
+            texture = ax::Director::getInstance()->getTextureCache()->addImage(d.textureFile);
+        }
+        if (!texture)
+        {
+            return nullptr;
+        }
+
+        // Same fields, in the same order, as ParticleSystem::initWithDictionary()
+        auto system = ax::ParticleSystemQuad::createWithTotalParticles(static_cast<int>(d.maxParticles));
+        system->setDuration(d.duration);
+        system->setBlendFunc(ax::BlendFunc{ax::utils::toBackendBlendFactor(static_cast<int>(d.blendSrc)),
+                                           ax::utils::toBackendBlendFactor(static_cast<int>(d.blendDst))});
+        system->setStartColor(ax::Color4F(d.startColor[0], d.startColor[1], d.startColor[2], d.startColor[3]));
+        system->setStartColorVar(
+            ax::Color4F(d.startColorVar[0], d.startColorVar[1], d.startColorVar[2], d.startColorVar[3]));
+        system->setEndColor(ax::Color4F(d.endColor[0], d.endColor[1], d.endColor[2], d.endColor[3]));
+        system->setEndColorVar(ax::Color4F(d.endColorVar[0], d.endColorVar[1], d.endColorVar[2], d.endColorVar[3]));
+        system->setStartSize(d.startSize);
+        system->setStartSizeVar(d.startSizeVar);
+        system->setEndSize(d.endSize);
+        system->setEndSizeVar(d.endSizeVar);
+        system->setPosVar(ax::Vec2(d.posVarX, d.posVarY));
+        system->setStartSpin(d.startSpin);
+        system->setStartSpinVar(d.startSpinVar);
+        system->setEndSpin(d.endSpin);
+        system->setEndSpinVar(d.endSpinVar);
+        system->setPositionType(static_cast<ax::ParticleSystem::PositionType>(d.positionType));
+
+        if (d.emitterType == 1)
+        {
+            system->setEmitterMode(ax::ParticleSystem::Mode::RADIUS);
+            system->setStartRadius(d.startRadius);
+            system->setStartRadiusVar(d.startRadiusVar);
+            system->setEndRadius(d.endRadius);
+            system->setEndRadiusVar(d.endRadiusVar);
+            system->setRotatePerSecond(d.rotatePerSecond);
+            system->setRotatePerSecondVar(d.rotatePerSecondVar);
+        }
+        else
+        {
+            system->setEmitterMode(ax::ParticleSystem::Mode::GRAVITY);
+            system->setGravity(ax::Vec2(d.gravityX, d.gravityY));
+            system->setSpeed(d.speed);
+            system->setSpeedVar(d.speedVar);
+            system->setRadialAccel(d.radialAccel);
+            system->setRadialAccelVar(d.radialAccelVar);
+            system->setTangentialAccel(d.tangentialAccel);
+            system->setTangentialAccelVar(d.tangentialAccelVar);
+        }
+
+        system->setLife(d.life);
+        system->setLifeVar(d.lifeVar);
+        system->setAngle(d.angle);
+        system->setAngleVar(d.angleVar);
+        system->setEmissionRate(d.life > 0.0f ? d.maxParticles / d.life : 0.0f);
+        system->setTexture(texture);
+        return system;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "axmol/axmol.h"
+#include "MappedFile.h"
+
+#include <string>
+#include <string_view>
+
+/**
+@brief  One emitter as laid out by tools/compile_particles.py.
+
+Field order and size must match the DESCRIPTOR struct in the compiler.
+*/
+struct ParticleDescriptor
+{
+    char name[32];
+    char textureFile[64];  // set when the texture is not embedded in the pack
+    uint32_t texture;      // index into the pack's texture table, or NO_TEXTURE
+    uint32_t emitterType;
+    uint32_t positionType;
+    uint32_t maxParticles;
+    uint32_t blendSrc;
+    uint32_t blendDst;
+    float duration;
+    float angle, angleVar;
+    float speed, speedVar;
+    float gravityX, gravityY;
+    float radialAccel, radialAccelVar;
+    float tangentialAccel, tangentialAccelVar;
+    float posVarX, posVarY;
+    float life, lifeVar;
+    float startSize, startSizeVar;
+    float endSize, endSizeVar;
+    float startSpin, startSpinVar;
+    float endSpin, endSpinVar;
+    float startColor[4], startColorVar[4];
+    float endColor[4], endColorVar[4];
+    float startRadius, startRadiusVar;
+    float endRadius, endRadiusVar;
+    float rotatePerSecond, rotatePerSecondVar;
+
+    static constexpr uint32_t NO_TEXTURE = 0xFFFFFFFF;
+};
+static_assert(sizeof(ParticleDescriptor) == 300, "ParticleDescriptor must match tools/compile_particles.py");
+
+/**
+@brief  Particle emitters precompiled from Content/particles/*.plist.
+
+The pack is mapped once and its textures are uploaded straight from the mapping,
+so creating an effect is just a handful of setters.
+*/
+class ParticlePack
+{
+public:
+    static ParticlePack* getInstance();
+    static void destroyInstance();
+
+    /**
+    @brief  Map a pack produced by tools/compile_particles.py.
+    @return false   The pack is missing or malformed. create() then returns nullptr.
+    */
+    bool load(std::string_view filename);
+
+    /**
+    @brief  Create an emitter by plist name, e.g. "explosion". Reloads the pack first if it was purged.
+    @return nullptr if the emitter is not in the pack. Otherwise an autorelease object.
+    */
+    ax::ParticleSystemQuad* create(std::string_view name);
+
+    /** Bytes of the uploaded textures plus the pack itself when it could not be mapped. */
+    size_t getResidentBytes() const;
+
+    /** Release the textures and the mapping until the next create() or reload(). */
+    void purge();
+
+    /** Load the last pack passed to load() again, unless create() already did. */
+    bool reload();
+
+    ~ParticlePack();
+
+private:
+    ParticlePack() = default;
+    void unload();
+
+    MappedFile _file;
+    std::string _filename;
+    const ParticleDescriptor* _emitters = nullptr;
+    uint32_t _emitterCount              = 0;
+    bool _purged                        = false;
+    std::vector<ax::Texture2D*> _textures;
+};
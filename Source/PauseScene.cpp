@@ -1,4 +1,5 @@
 #include "PauseScene.h"
+#include "FramePacer.h"
 
 Pause::Pause() : _director(nullptr), _visibleSize(ax::Size()) {}
 
@@ -13,6 +14,7 @@ bool Pause::init()
     {
         return false;
     }
+    setName("Pause");
 
     _director       = ax::Director::getInstance();
     _visibleSize    = _director->getVisibleSize();
@@ -34,6 +36,19 @@ bool Pause::init()
     return true;
 }
 
+// The pause screen never animates, so it only needs redrawing on input
+void Pause::onEnterTransitionDidFinish()
+{
+    Scene::onEnterTransitionDidFinish();
+    FramePacer::getInstance()->setSceneIdle(this, true);
+}
+
+void Pause::onExit()
+{
+    FramePacer::getInstance()->setSceneIdle(this, false);
+    Scene::onExit();
+}
+
 void Pause::exitPause(ax::Object* pSender)
 {
     _director->popScene();
@@ -9,6 +9,8 @@ public:
     ~Pause() = default;
     static ax::Scene* createScene();
     bool init() override;
+    void onEnterTransitionDidFinish() override;
+    void onExit() override;
     void exitPause(ax::Object* pSender);
 
 private:
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+@brief  Nearest-rank percentile of `samples`, `p` in [0, 1]. Returns 0 when empty.
+
+Partially reorders `samples`.
+*/
+inline float percentileOf(std::vector<float>& samples, float p)
+{
+    if (samples.empty())
+    {
+        return 0.0f;
+    }
+
+    size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+    auto nth    = samples.begin() + (rank > 0 ? rank - 1 : 0);
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
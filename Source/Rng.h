@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+@brief  Small seedable random generator (PCG32) whose whole state is one integer.
+
+Gameplay draws from its own instance instead of the engine's global generator,
+so a round can be saved, restored and replayed exactly.
+*/
+class Rng
+{
+public:
+    explicit Rng(uint64_t seed = 0) { setState(seed); }
+
+    uint32_t next()
+    {
+        uint64_t state      = _state;
+        _state              = state * 6364136223846793005ull + INCREMENT;
+        uint32_t xorShifted = static_cast<uint32_t>(((state >> 18u) ^ state) >> 27u);
+        uint32_t rotation   = static_cast<uint32_t>(state >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+    }
+
+    /** Uniform in [0, 1). */
+    float next01() { return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f); }
+
+    /** Uniform in [low, high). */
+    float range(float low, float high) { return low + (high - low) * next01(); }
+
+    uint64_t getState() const { return _state; }
+    void setState(uint64_t state) { _state = state; }
+
+private:
+    static constexpr uint64_t INCREMENT = 1442695040888963407ull;
+
+    uint64_t _state;
+};
@@ -0,0 +1,314 @@
+#include "RollbackSession.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+constexpr uint8_t PACKET_MAGIC  = 'V';
+constexpr size_t INPUT_BYTES    = 11;                 // flags and five int16
+constexpr size_t HEADER_BYTES   = 1 + 1 + 4 + 4 + 1;  // magic, match, ack, first frame, input count
+constexpr size_t CHECKSUM_BYTES = 4 + 8;              // frame and checksum
+
+uint64_t steadyUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Both peers run the same build, so fields go out in host byte order
+template <typename T>
+uint8_t* put(uint8_t* out, T value)
+{
+    memcpy(out, &value, sizeof(T));
+    return out + sizeof(T);
+}
+
+template <typename T>
+const uint8_t* get(const uint8_t* in, T& value)
+{
+    memcpy(&value, in, sizeof(T));
+    return in + sizeof(T);
+}
+
+uint8_t* putInput(uint8_t* out, const VersusInput& input)
+{
+    out = put(out, input.flags);
+    out = put(out, input.tapX);
+    out = put(out, input.tapY);
+    out = put(out, input.dragX);
+    out = put(out, input.dragY);
+    return put(out, input.tilt);
+}
+
+const uint8_t* getInput(const uint8_t* in, VersusInput& input)
+{
+    in = get(in, input.flags);
+    in = get(in, input.tapX);
+    in = get(in, input.tapY);
+    in = get(in, input.dragX);
+    in = get(in, input.dragY);
+    return get(in, input.tilt);
+}
+}  // namespace
+
+RollbackSession::Settings RollbackSession::Settings::fromConfig(const GameConfig& config)
+{
+    Settings settings;
+    settings.inputDelay  = std::min(config.versusDelay, MAX_INPUT_DELAY);
+    settings.maxRollback = std::clamp(config.versusRollback, 1u, MAX_ROLLBACK);
+    return settings;
+}
+
+RollbackSession::RollbackSession(VersusRound& round, VersusTransport& transport, int localPlayer,
+                                 const Settings& settings)
+    : _round(round)
+    , _transport(transport)
+    , _localPlayer(localPlayer)
+    , _settings(settings)
+    , _match(0)
+    , _frames(0)
+    , _stalls(0)
+    , _rollbacks(0)
+    , _resimFrames(0)
+    , _desyncs(0)
+{
+    _settings.inputDelay  = std::min(_settings.inputDelay, MAX_INPUT_DELAY);
+    _settings.maxRollback = std::clamp(_settings.maxRollback, 1u, MAX_ROLLBACK);
+    _checksums.fill(0);
+    _depths.fill(0);
+    reset();
+}
+
+void RollbackSession::reset()
+{
+    ++_match;
+    _localInputs.fill(VersusInput{});
+    _remoteInputs.fill(VersusInput{});
+    _usedRemote.fill(VersusInput{});
+
+    // Nobody has input for the first frames of the delay, so both sides know those are empty
+    _localNext         = _settings.inputDelay;
+    _remoteConfirmed   = _settings.inputDelay;
+    _remoteAck         = _settings.inputDelay;
+    _firstWrong        = NONE;
+    _peerChecksumFrame = NONE;
+    _peerChecksum      = 0;
+}
+
+bool RollbackSession::advance(const VersusInput& localInput, uint64_t nowUs)
+{
+    const uint32_t frame = _round.getFrame();
+
+    // While stalled this frame's slot is already taken; the input is dropped rather than delayed further
+    if (_localNext <= frame + _settings.inputDelay)
+    {
+        _localInputs[_localNext % RING] = localInput;
+        ++_localNext;
+    }
+
+    _transport.poll(nowUs, [this](const uint8_t* data, size_t size) { receive(data, size); });
+
+    uint64_t resimUs = 0;
+    if (_firstWrong != NONE)
+    {
+        uint64_t start = steadyUs();
+        rollBack(frame);
+        resimUs     = steadyUs() - start;
+        _firstWrong = NONE;
+    }
+    _resimCost.record(resimUs);
+    checkPeerChecksum();
+
+    bool stepped = frame < _remoteConfirmed + _settings.maxRollback;
+    if (stepped)
+    {
+        simulate(frame);
+        ++_frames;
+    }
+    else
+    {
+        ++_stalls;
+    }
+
+    sendInputs(nowUs);
+    return stepped;
+}
+
+void RollbackSession::simulate(uint32_t frame)
+{
+    const uint32_t slot = frame % RING;
+    _round.save(_states[slot]);
+
+    std::array<VersusInput, VersusRound::PLAYERS> inputs;
+    inputs[_localPlayer]     = _localInputs[slot];
+    inputs[1 - _localPlayer] = frame < _remoteConfirmed ? _remoteInputs[slot] : predictRemote();
+    _usedRemote[slot]        = inputs[1 - _localPlayer];
+
+    _round.step(inputs);
+    _checksums[slot] = _round.checksum();
+}
+
+// Players hold a drag or a tilt for many frames, but a tap is one frame; repeating it would explode phantom bombs
+VersusInput RollbackSession::predictRemote() const
+{
+    if (_remoteConfirmed == 0)
+    {
+        return VersusInput{};
+    }
+    VersusInput input = _remoteInputs[(_remoteConfirmed - 1) % RING];
+    input.flags &= ~VersusInput::TAP;
+    return input;
+}
+
+void RollbackSession::rollBack(uint32_t frame)
+{
+    const uint32_t from = _firstWrong;
+    _round.restore(_states[from % RING]);
+    for (uint32_t f = from; f < frame; ++f)
+    {
+        simulate(f);
+    }
+
+    const uint32_t depth = frame - from;
+    ++_rollbacks;
+    _resimFrames += depth;
+    ++_depths[std::min(depth, MAX_ROLLBACK)];
+}
+
+void RollbackSession::receive(const uint8_t* data, size_t size)
+{
+    if (size < HEADER_BYTES + CHECKSUM_BYTES || data[0] != PACKET_MAGIC || data[1] != _match)
+    {
+        return;
+    }
+
+    uint32_t ack, first;
+    uint8_t count;
+    const uint8_t* in = get(data + 2, ack);
+    in                = get(in, first);
+    in                = get(in, count);
+    if (size != HEADER_BYTES + count * INPUT_BYTES + CHECKSUM_BYTES)
+    {
+        return;
+    }
+
+    _remoteAck = std::clamp(ack, _remoteAck, _localNext);
+
+    const uint32_t frame = _round.getFrame();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        VersusInput input;
+        in = getInput(in, input);
+
+        // Only the next missing frame counts; a gap waits for the packet that fills it
+        if (first + i != _remoteConfirmed)
+        {
+            continue;
+        }
+        const uint32_t slot = _remoteConfirmed % RING;
+        _remoteInputs[slot] = input;
+        if (_remoteConfirmed < frame && _usedRemote[slot] != input)
+        {
+            _firstWrong = std::min(_firstWrong, _remoteConfirmed);
+        }
+        ++_remoteConfirmed;
+    }
+
+    uint32_t checksumFrame;
+    uint64_t checksum;
+    in = get(in, checksumFrame);
+    get(in, checksum);
+    if (checksumFrame != NONE && (_peerChecksumFrame == NONE || checksumFrame > _peerChecksumFrame))
+    {
+        _peerChecksumFrame = checksumFrame;
+        _peerChecksum      = checksum;
+    }
+}
+
+// Only frames confirmed on both sides are compared; a predicted frame may differ and still be fine
+void RollbackSession::checkPeerChecksum()
+{
+    const uint32_t frame = _round.getFrame();
+    if (_peerChecksumFrame == NONE || _peerChecksumFrame >= _remoteConfirmed || _peerChecksumFrame >= frame)
+    {
+        return;
+    }
+
+    if (_peerChecksumFrame + RING > frame && _checksums[_peerChecksumFrame % RING] != _peerChecksum)
+    {
+        if (_desyncs == 0)
+        {
+            AXLOGW("RollbackSession: player {} desynced at frame {}", _localPlayer, _peerChecksumFrame);
+        }
+        ++_desyncs;
+    }
+    _peerChecksumFrame = NONE;
+}
+
+void RollbackSession::sendInputs(uint64_t nowUs)
+{
+    // Everything the peer has not acknowledged yet, oldest first, so one packet arriving covers every lost one
+    uint32_t first = std::max(_remoteAck, _localNext > RING ? _localNext - RING : 0u);
+    uint32_t count = std::min(_localNext - first, MAX_INPUTS_PER_PACKET);
+
+    std::array<uint8_t, HEADER_BYTES + MAX_INPUTS_PER_PACKET * INPUT_BYTES + CHECKSUM_BYTES> packet;
+    static_assert(sizeof(packet) <= VersusTransport::MAX_PACKET, "a packet has to fit the transport");
+
+    uint8_t* out = packet.data();
+    out          = put(out, PACKET_MAGIC);
+    out          = put(out, _match);
+    out          = put(out, _remoteConfirmed);
+    out          = put(out, first);
+    out          = put(out, static_cast<uint8_t>(count));
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        out = putInput(out, _localInputs[(first + i) % RING]);
+    }
+
+    // The newest frame this side has simulated with confirmed inputs only
+    const uint32_t confirmed = std::min(_remoteConfirmed, _round.getFrame());
+    const uint32_t checksumFrame =
+        confirmed > 0 && confirmed - 1 + RING > _round.getFrame() ? confirmed - 1 : NONE;
+    out = put(out, checksumFrame);
+    out = put(out, checksumFrame != NONE ? _checksums[checksumFrame % RING] : uint64_t(0));
+
+    _transport.send(packet.data(), static_cast<size_t>(out - packet.data()), nowUs);
+}
+
+std::string RollbackSession::buildReport() const
+{
+    std::string report;
+    report += ax::StringUtils::format("player: %d\n", _localPlayer);
+    report += ax::StringUtils::format("input_delay: %u max_rollback: %u\n", _settings.inputDelay,
+                                      _settings.maxRollback);
+    report += ax::StringUtils::format("frames: %u stalled: %u (%.2f%%)\n", _frames, _stalls,
+                                      100.0 * _stalls / std::max(1u, _frames + _stalls));
+    report += ax::StringUtils::format("rollbacks: %u (%.1f per 100 frames) resimulated_frames: %llu\n", _rollbacks,
+                                      100.0 * _rollbacks / std::max(1u, _frames),
+                                      static_cast<unsigned long long>(_resimFrames));
+
+    report += "rollback_depth:";
+    for (uint32_t depth = 1; depth <= MAX_ROLLBACK; ++depth)
+    {
+        if (_depths[depth])
+        {
+            report += ax::StringUtils::format(" %u:%u", depth, _depths[depth]);
+        }
+    }
+    report += "\n";
+
+    report += ax::StringUtils::format(
+        "resim_us_per_frame: p50 %llu p95 %llu p99 %llu max %llu over_budget(%llu us): %llu\n",
+        static_cast<unsigned long long>(_resimCost.percentile(0.50f)),
+        static_cast<unsigned long long>(_resimCost.percentile(0.95f)),
+        static_cast<unsigned long long>(_resimCost.percentile(0.99f)),
+        static_cast<unsigned long long>(_resimCost.max()), static_cast<unsigned long long>(_settings.resimBudgetUs),
+        static_cast<unsigned long long>(_resimCost.countAbove(_settings.resimBudgetUs)));
+    report += ax::StringUtils::format("packets_sent: %u lost_in_simulation: %u\n", _transport.getSentCount(),
+                                      _transport.getLostCount());
+    report += ax::StringUtils::format("desyncs: %u\n", _desyncs);
+    return report;
+}
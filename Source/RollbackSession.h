@@ -0,0 +1,102 @@
+#pragma once
+
+#include "GameConfig.h"
+#include "HdrHistogram.h"
+#include "VersusRound.h"
+#include "VersusTransport.h"
+
+#include <array>
+#include <string>
+
+/**
+@brief  Keeps a VersusRound in step with a remote peer: input delay, prediction and rollback.
+
+Each frame the local input is scheduled `inputDelay` frames ahead and sent along
+with every earlier input the peer has not acknowledged, so a lost packet is
+covered by the next one. A remote input that has not arrived is predicted as
+the last one without its tap. When the real one arrives and differs, the round
+is restored to that frame and every frame since is simulated again, within the
+same advance(). The session never predicts more than `maxRollback` frames;
+beyond that it stalls, leaving the frame unstepped until the peer catches up.
+
+The peers trade checksums of confirmed frames, so a desync shows up in the
+report rather than as two different games. The report has the resimulation
+cost per frame, rollback depths, stalls and packet counts.
+*/
+class RollbackSession
+{
+public:
+    struct Settings
+    {
+        uint32_t inputDelay    = 2;     // frames, at most MAX_INPUT_DELAY
+        uint32_t maxRollback   = 8;     // frames, at most MAX_ROLLBACK
+        uint64_t resimBudgetUs = 4000;  // resimulation per frame beyond this is counted in the report
+
+        static Settings fromConfig(const GameConfig& config);
+    };
+
+    static constexpr uint32_t MAX_INPUT_DELAY = 8;
+    static constexpr uint32_t MAX_ROLLBACK    = 20;
+
+    RollbackSession(VersusRound& round, VersusTransport& transport, int localPlayer, const Settings& settings);
+
+    /** Start a match at frame 0 on a round both peers set up alike. Packets of the previous match are ignored. */
+    void reset();
+
+    /**
+    @brief  One frame: schedule `localInput`, take in what the peer sent, roll back if needed, step once.
+    @return false while stalled waiting for the peer; the round did not move.
+    */
+    bool advance(const VersusInput& localInput, uint64_t nowUs);
+
+    int getLocalPlayer() const { return _localPlayer; }
+
+    /** The match is over and no late input can change how it ended. */
+    bool isDecided() const { return _round.isOver() && _remoteConfirmed >= _round.getEndFrame(); }
+
+    uint32_t getDesyncCount() const { return _desyncs; }
+    uint32_t getRollbackCount() const { return _rollbacks; }
+    const HdrHistogram& getResimCost() const { return _resimCost; }
+
+    std::string buildReport() const;
+
+private:
+    static constexpr uint32_t RING                  = 64;  // covers every frame the two peers can be apart
+    static constexpr uint32_t MAX_INPUTS_PER_PACKET = 32;
+    static constexpr uint32_t NONE                  = ~0u;
+
+    void simulate(uint32_t frame);
+    VersusInput predictRemote() const;
+    void rollBack(uint32_t frame);
+    void receive(const uint8_t* data, size_t size);
+    void checkPeerChecksum();
+    void sendInputs(uint64_t nowUs);
+
+    VersusRound& _round;
+    VersusTransport& _transport;
+    const int _localPlayer;
+    Settings _settings;
+    uint8_t _match;
+
+    // Indexed by frame % RING
+    std::array<VersusInput, RING> _localInputs;
+    std::array<VersusInput, RING> _remoteInputs;  // confirmed
+    std::array<VersusInput, RING> _usedRemote;    // what the frame was last simulated with
+    std::array<VersusRound::State, RING> _states;  // before the frame
+    std::array<uint64_t, RING> _checksums;         // after the frame
+
+    uint32_t _localNext;        // the next frame a local input is scheduled for
+    uint32_t _remoteConfirmed;  // remote inputs are known for every frame below this
+    uint32_t _remoteAck;        // the peer has our inputs for every frame below this
+    uint32_t _firstWrong;       // earliest frame simulated with a wrong prediction, or NONE
+    uint32_t _peerChecksumFrame;
+    uint64_t _peerChecksum;
+
+    uint32_t _frames;
+    uint32_t _stalls;
+    uint32_t _rollbacks;
+    uint64_t _resimFrames;
+    uint32_t _desyncs;
+    std::array<uint32_t, MAX_ROLLBACK + 1> _depths;
+    HdrHistogram _resimCost;  // microseconds of resimulation per advance(), zero when there was none
+};
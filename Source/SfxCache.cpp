@@ -0,0 +1,354 @@
+#include "SfxCache.h"
+#include "AudioStartup.h"
+#include "MappedFile.h"
+#include "SystemTimings.h"
+#include "axmol/audio/AudioEngine.h"
+
+#if AX_TARGET_PLATFORM != AX_PLATFORM_WASM
+#    include "axmol/audio/AudioDecoder.h"
+#    include "axmol/audio/AudioDecoderManager.h"
+#    include "axmol/audio/alconfig.h"
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+struct CacheHeader
+{
+    char magic[4];  // "HSFX"
+    uint32_t version;
+    uint64_t sourceHash;
+    uint32_t sampleRate;
+    uint32_t channels;
+    uint32_t dataBytes;  // 16-bit interleaved samples follow the header
+    uint32_t reserved;
+};
+static_assert(sizeof(CacheHeader) == 32, "CacheHeader is a file format");
+
+// Bump when the decoders or the layout change, so old files stop matching
+constexpr uint32_t CACHE_VERSION = 1;
+
+// Effects that can overlap; the oldest is cut off when all are busy
+constexpr size_t VOICE_COUNT = 8;
+
+SfxCache* s_sharedSfxCache = nullptr;
+
+// FNV-1a; the source files are a few KiB, so this costs microseconds
+uint64_t hashContent(const uint8_t* data, size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ data[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::string cacheDirectory()
+{
+    return ax::FileUtils::getInstance()->getWritablePath() + "sfx_cache/";
+}
+}  // namespace
+
+SfxCache* SfxCache::getInstance()
+{
+    if (!s_sharedSfxCache)
+    {
+        s_sharedSfxCache = new SfxCache();
+    }
+    return s_sharedSfxCache;
+}
+
+void SfxCache::destroyInstance()
+{
+    delete s_sharedSfxCache;
+    s_sharedSfxCache = nullptr;
+}
+
+SfxCache::~SfxCache()
+{
+#if AX_TARGET_PLATFORM != AX_PLATFORM_WASM
+    stopAll();
+    if (!_sources.empty())
+    {
+        alDeleteSources(static_cast<ALsizei>(_sources.size()), _sources.data());
+    }
+    for (const auto& effect : _effects)
+    {
+        alDeleteBuffers(1, &effect.buffer);
+    }
+#endif
+}
+
+bool SfxCache::preload(std::string_view filename)
+{
+#if AX_TARGET_PLATFORM == AX_PLATFORM_WASM
+    ax::AudioEngine::preload(filename);
+    return false;
+#else
+    for (const auto& effect : _effects)
+    {
+        if (effect.filename == filename)
+        {
+            return true;
+        }
+    }
+
+    auto fileUtils         = ax::FileUtils::getInstance();
+    std::string sourcePath = fileUtils->fullPathForFilename(filename);
+    ax::Data source        = fileUtils->getDataFromFile(sourcePath);
+    if (source.isNull())
+    {
+        return false;
+    }
+
+    uint64_t hash         = hashContent(source.getBytes(), source.getSize());
+    std::string cachePath = cacheDirectory() + ax::StringUtils::format("%016llx.pcm", (unsigned long long)hash);
+
+    if (_sources.empty())
+    {
+        _sources.resize(VOICE_COUNT);
+        alGenSources(static_cast<ALsizei>(VOICE_COUNT), _sources.data());
+    }
+
+    Effect effect{std::string(filename), cachePath, 0, 0};
+    alGenBuffers(1, &effect.buffer);
+    if (!loadCached(cachePath, hash, effect.buffer, effect.bytes))
+    {
+        bool cached = false;
+        if (!decodeAndCache(sourcePath, cachePath, hash, effect.buffer, effect.bytes, cached))
+        {
+            AXLOGW("SfxCache: cannot decode {}, it will play through AudioEngine", filename);
+            alDeleteBuffers(1, &effect.buffer);
+            return false;
+        }
+        if (!cached)
+        {
+            effect.cacheFile.clear();
+        }
+    }
+
+    _effects.push_back(std::move(effect));
+    return true;
+#endif
+}
+
+bool SfxCache::loadCached(const std::string& cachePath, uint64_t sourceHash, unsigned int buffer, size_t& bytes)
+{
+#if AX_TARGET_PLATFORM != AX_PLATFORM_WASM
+    MappedFile file;
+    if (!file.open(cachePath))
+    {
+        return false;
+    }
+
+    auto header = reinterpret_cast<const CacheHeader*>(file.data());
+    if (file.size() < sizeof(CacheHeader) || memcmp(header->magic, "HSFX", 4) != 0 ||
+        header->version != CACHE_VERSION || header->sourceHash != sourceHash || header->channels == 0 ||
+        header->channels > 2 || file.size() < sizeof(CacheHeader) + size_t(header->dataBytes))
+    {
+        AXLOGW("SfxCache: ignoring stale cache file {}", cachePath);
+        return false;
+    }
+
+    // OpenAL copies the samples, so the mapping can go right away
+    alBufferData(buffer, header->channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16,
+                 file.data() + sizeof(CacheHeader), static_cast<ALsizei>(header->dataBytes),
+                 static_cast<ALsizei>(header->sampleRate));
+    _cacheBytes += file.size();
+    bytes = header->dataBytes;
+    return alGetError() == AL_NO_ERROR;
+#else
+    return false;
+#endif
+}
+
+bool SfxCache::decodeAndCache(const std::string& sourcePath, const std::string& cachePath, uint64_t sourceHash,
+                              unsigned int buffer, size_t& bytes, bool& cached)
+{
+#if AX_TARGET_PLATFORM != AX_PLATFORM_WASM
+    ax::AudioDecoder* decoder = ax::AudioDecoderManager::createDecoder(sourcePath);
+    if (!decoder || !decoder->open(sourcePath) || decoder->getChannelCount() == 0 || decoder->getChannelCount() > 2)
+    {
+        ax::AudioDecoderManager::destroyDecoder(decoder);
+        return false;
+    }
+
+    CacheHeader header;
+    memcpy(header.magic, "HSFX", 4);
+    header.version    = CACHE_VERSION;
+    header.sourceHash = sourceHash;
+    header.sampleRate = decoder->getSampleRate();
+    header.channels   = decoder->getChannelCount();
+    header.reserved   = 0;
+
+    const uint32_t bytesPerFrame = decoder->getBytesPerFrame();
+    std::vector<char> pcm(size_t(decoder->getTotalFrames()) * bytesPerFrame);
+    bytes = 0;
+    while (bytes < pcm.size())
+    {
+        uint32_t frames = decoder->read(static_cast<uint32_t>((pcm.size() - bytes) / bytesPerFrame), &pcm[bytes]);
+        if (frames == 0)
+        {
+            break;
+        }
+        bytes += size_t(frames) * bytesPerFrame;
+    }
+    ax::AudioDecoderManager::destroyDecoder(decoder);
+    header.dataBytes = static_cast<uint32_t>(bytes);
+
+    alBufferData(buffer, header.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16, pcm.data(),
+                 static_cast<ALsizei>(bytes), static_cast<ALsizei>(header.sampleRate));
+    if (alGetError() != AL_NO_ERROR)
+    {
+        return false;
+    }
+
+    size_t fileBytes = sizeof(CacheHeader) + bytes;
+    if (_cacheBytes + fileBytes > _sizeCap)
+    {
+        AXLOGI("SfxCache: {} not cached, the cache is full", sourcePath);
+        return true;
+    }
+
+    ax::FileUtils::getInstance()->createDirectory(cacheDirectory());
+    std::ofstream out(cachePath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(pcm.data(), static_cast<std::streamsize>(bytes));
+    cached = static_cast<bool>(out);
+    if (cached)
+    {
+        _cacheBytes += fileBytes;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SfxCache::prune()
+{
+    auto fileUtils = ax::FileUtils::getInstance();
+    for (const auto& path : fileUtils->listFiles(cacheDirectory()))
+    {
+        if (path.empty() || path.back() == '/')
+        {
+            continue;
+        }
+
+        bool used = false;
+        for (const auto& effect : _effects)
+        {
+            used = used || effect.cacheFile == path;
+        }
+        if (!used)
+        {
+            AXLOGD("SfxCache: removing {}", path);
+            fileUtils->removeFile(path);
+        }
+    }
+}
+
+void SfxCache::play(std::string_view filename, float volume)
+{
+    PERF_SCOPE(SystemTimings::System::Audio);
+    if (auto startup = AudioStartup::getInstance(); startup->isPending())
+    {
+        startup->queueEffect(filename, volume);
+        return;
+    }
+
+#if AX_TARGET_PLATFORM != AX_PLATFORM_WASM
+    // Purged under memory pressure: mapping the PCM cache again is cheap, decoding through AudioEngine is not
+    auto purged = std::find(_purged.begin(), _purged.end(), filename);
+    if (purged != _purged.end())
+    {
+        _purged.erase(purged);
+        preload(filename);
+    }
+
+    for (const auto& effect : _effects)
+    {
+        if (effect.filename != filename)
+        {
+            continue;
+        }
+
+        // Prefer an idle voice; otherwise cut off the one started longest ago
+        ALuint source = _sources[_nextSource];
+        for (size_t i = 0; i < _sources.size(); ++i)
+        {
+            size_t index = (_nextSource + i) % _sources.size();
+            ALint state  = AL_STOPPED;
+            alGetSourcei(_sources[index], AL_SOURCE_STATE, &state);
+            if (state != AL_PLAYING)
+            {
+                source      = _sources[index];
+                _nextSource = index;
+                break;
+            }
+        }
+        _nextSource = (_nextSource + 1) % _sources.size();
+
+        alSourceStop(source);
+        alSourcei(source, AL_BUFFER, static_cast<ALint>(effect.buffer));
+        alSourcef(source, AL_GAIN, volume);
+        alSourcePlay(source);
+        return;
+    }
+#endif
+    ax::AudioEngine::play2d(filename, false, volume);
+}
+
+size_t SfxCache::getResidentBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& effect : _effects)
+    {
+        bytes += effect.bytes;
+    }
+    return bytes;
+}
+
+void SfxCache::purge()
+{
+    stopAll();
+#if AX_TARGET_PLATFORM != AX_PLATFORM_WASM
+    // Voices keep a reference to their last buffer, which would keep it from being deleted
+    for (auto source : _sources)
+    {
+        alSourcei(source, AL_BUFFER, 0);
+    }
+    for (const auto& effect : _effects)
+    {
+        alDeleteBuffers(1, &effect.buffer);
+        _purged.push_back(effect.filename);
+    }
+#endif
+    _effects.clear();
+    _cacheBytes = 0;
+    ax::AudioEngine::uncacheAll();
+}
+
+void SfxCache::reload()
+{
+    std::vector<std::string> filenames;
+    filenames.swap(_purged);
+    for (const auto& filename : filenames)
+    {
+        preload(filename);
+    }
+}
+
+void SfxCache::stopAll()
+{
+#if AX_TARGET_PLATFORM != AX_PLATFORM_WASM
+    for (auto source : _sources)
+    {
+        alSourceStop(source);
+    }
+#endif
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "axmol/axmol.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+@brief  Short sound effects played from decoded PCM kept in the writable path.
+
+The first preload() of an effect decodes it once and writes the samples to
+`<writable path>/sfx_cache/<content hash>.pcm`. Later launches hash the source
+file, map the matching cache file and upload it straight to an OpenAL buffer, so
+no MP3 is decoded at startup or on first play. Changed assets hash differently
+and get a new cache file; prune() deletes the ones nothing refers to any more.
+Effects are only cached while the cache stays under its size cap.
+
+Web builds, and effects that were never preloaded, play through AudioEngine.
+*/
+class SfxCache
+{
+public:
+    static SfxCache* getInstance();
+    static void destroyInstance();
+
+    /** Total bytes of cache files this cache may keep. Defaults to 4 MiB. */
+    void setSizeCap(size_t bytes) { _sizeCap = bytes; }
+
+    /**
+    @brief  Make `filename` ready to play. Needs an initialized AudioEngine.
+    @return false   The effect cannot be decoded; play() falls back to AudioEngine.
+    */
+    bool preload(std::string_view filename);
+
+    /** Delete cache files that no preloaded effect refers to. */
+    void prune();
+
+    /** Queued by AudioStartup while the device is still opening. */
+    void play(std::string_view filename, float volume = 1.0f);
+    void stopAll();
+
+    /** Bytes of decoded samples held by OpenAL. */
+    size_t getResidentBytes() const;
+
+    /** Free the decoded samples. Each effect is loaded again from the PCM cache when it next plays, or by reload(). */
+    void purge();
+
+    /** Preload again what purge() freed; cheap, since the PCM cache is still on disk. */
+    void reload();
+
+    ~SfxCache();
+
+private:
+    struct Effect
+    {
+        std::string filename;
+        std::string cacheFile;  // empty when over the size cap
+        unsigned int buffer;    // OpenAL buffer name
+        size_t bytes;           // decoded samples in that buffer
+    };
+
+    SfxCache() = default;
+    bool loadCached(const std::string& cachePath, uint64_t sourceHash, unsigned int buffer, size_t& bytes);
+    bool decodeAndCache(const std::string& sourcePath, const std::string& cachePath, uint64_t sourceHash,
+                        unsigned int buffer, size_t& bytes, bool& cached);
+
+    std::vector<Effect> _effects;
+    std::vector<std::string> _purged;
+    std::vector<unsigned int> _sources;  // OpenAL voices, reused round-robin
+    size_t _nextSource = 0;
+    size_t _cacheBytes = 0;
+    size_t _sizeCap    = 4 * 1024 * 1024;
+};
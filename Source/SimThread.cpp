@@ -0,0 +1,160 @@
+#include "SimThread.h"
+
+#include <chrono>
+
+namespace
+{
+// Further behind than this and the lost time is dropped: the round slows down instead of never catching up
+constexpr int MAX_LAG_STEPS = 5;
+}  // namespace
+
+SimThread::SimThread(GameRound& round, InputQueue& input, float stepsPerSecond, size_t bombCapacity)
+    : _round(round)
+    , _input(input)
+    , _step(1.0f / stepsPerSecond)
+    , _suggestBotMoves(false)
+    , _back(0)
+    , _shared(1)
+    , _front(2)
+    , _pendingCount(0)
+    , _steps(0)
+{
+    for (auto& frame : _frames)
+    {
+        frame.bombs.reserve(bombCapacity);
+        frame.speeds.reserve(bombCapacity);
+    }
+}
+
+SimThread::~SimThread()
+{
+    stop();
+}
+
+void SimThread::start()
+{
+    if (_thread.joinable())
+    {
+        return;
+    }
+
+    // Until the thread publishes, latest() shows the round as it is handed over
+    _steps = 0;
+    publish();
+    _stopping.store(false, std::memory_order_relaxed);
+    _thread = std::thread([this] { run(); });
+}
+
+void SimThread::stop()
+{
+    if (!_thread.joinable())
+    {
+        return;
+    }
+    _stopping.store(true, std::memory_order_relaxed);
+    _thread.join();
+}
+
+const RoundFrame& SimThread::latest()
+{
+    if (_shared.load(std::memory_order_relaxed) & FRESH)
+    {
+        _front = _shared.exchange(_front, std::memory_order_acq_rel) & ~FRESH;
+    }
+    return _frames[_front];
+}
+
+void SimThread::run()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(_step));
+
+    auto next = Clock::now();
+    while (!_stopping.load(std::memory_order_relaxed))
+    {
+        _input.drain([this](const InputEvent& event) { apply(event); });
+        if (_stepHook)
+        {
+            _stepHook(_round);
+        }
+        bool alive = _round.step(_step);
+        ++_steps;
+        publish();
+        if (!alive)
+        {
+            break;
+        }
+
+        next += period;
+        auto now = Clock::now();
+        if (now - next > period * MAX_LAG_STEPS)
+        {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void SimThread::apply(const InputEvent& event)
+{
+    switch (event.type)
+    {
+    case InputEvent::Type::TouchBegan:
+        _round.tap(ax::Vec2(event.x, event.y), [this](const ax::Vec2& position) {
+            addEvent(Event{Event::Type::Explosion, {}, position});
+        });
+        break;
+    case InputEvent::Type::TouchMoved:
+        _round.dragPlayer(ax::Vec2(event.x, event.y));
+        break;
+    case InputEvent::Type::Acceleration:
+        _round.tiltPlayer(event.x);
+        break;
+    case InputEvent::Type::KeyReleased:
+        break;
+    default:
+        return;
+    }
+    addEvent(Event{Event::Type::Applied, event, ax::Vec2::ZERO});
+}
+
+void SimThread::addEvent(const Event& event)
+{
+    // A tap into a pile of bombs can overflow the step's share; those go out a frame early
+    if (_pendingCount < _pending.size())
+    {
+        _pending[_pendingCount++] = event;
+    }
+    else if (!_events.push(event))
+    {
+        _droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SimThread::publish()
+{
+    RoundFrame& frame = _frames[_back];
+    frame.step        = _steps;
+    frame.published   = InputQueue::now();
+    frame.player      = _round.getPlayerPosition();
+    frame.bombs.clear();
+    frame.speeds.clear();
+    _round.forEachBomb([&frame](const ax::Vec2& position, float speed) {
+        frame.bombs.push_back(position);
+        frame.speeds.push_back(speed);
+    });
+    frame.score   = _round.getScore();
+    frame.over    = _round.isOver();
+    frame.botMove = _suggestBotMoves ? _round.suggestBotMove() : GameRound::BotMove{};
+
+    _back = _shared.exchange(_back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+
+    for (size_t i = 0; i < _pendingCount; ++i)
+    {
+        if (!_events.push(_pending[i]))
+        {
+            _droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    _pendingCount = 0;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "axmol/axmol.h"
+#include "GameRound.h"
+#include "InputQueue.h"
+#include "SpscRing.h"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/** What the simulation thread publishes after each step: everything the scene draws. */
+struct RoundFrame
+{
+    uint64_t step      = 0;  // steps since start() when published
+    uint64_t published = 0;  // InputQueue::now() at publication
+    ax::Vec2 player;
+    std::vector<ax::Vec2> bombs;  // centers
+    std::vector<float> speeds;    // points per second, parallel to bombs
+    int score = 0;
+    bool over = false;
+    GameRound::BotMove botMove;  // only filled when suggesting bot moves
+};
+
+/**
+@brief  Plays a GameRound on its own thread at a fixed rate, for the threaded-sim mode.
+
+The scene hands its round over with start() and gets it back with stop(); in
+between only this thread touches the round. Input still goes through the
+scene's InputQueue, whose consumer becomes this thread. After every step the
+round is copied into one of three RoundFrame slots: the thread always has a
+slot to write, latest() always has a complete one to read, and neither side
+waits for the other, so draw time and step time overlap instead of adding up.
+
+Explosions and applied inputs go back through a ring rather than the frames,
+so none are lost when the main thread skips a frame. They are pushed after
+the frame that shows them, so draining them before latest() never runs ahead
+of what is on screen.
+*/
+class SimThread
+{
+public:
+    /** Applied to the round on this thread before every step, e.g. to keep a stress test's bombs topped up. */
+    using StepHook = std::function<void(GameRound&)>;
+
+    struct Event
+    {
+        enum class Type : uint8_t
+        {
+            Applied,    // `input` was applied to the round; KeyReleased is left to the scene
+            Explosion,  // a tap exploded the bomb at `position`
+        };
+
+        Type type;
+        InputEvent input;
+        ax::Vec2 position;
+    };
+
+    /** `stepsPerSecond` is the fixed rate the round is stepped at; `bombCapacity` sizes the frames up front. */
+    SimThread(GameRound& round, InputQueue& input, float stepsPerSecond, size_t bombCapacity);
+    ~SimThread();
+
+    SimThread(const SimThread&)            = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    void setStepHook(StepHook hook) { _stepHook = std::move(hook); }
+
+    /** Publish GameRound::suggestBotMove() with every frame, for autoplay. */
+    void setSuggestBotMoves(bool suggest) { _suggestBotMoves = suggest; }
+
+    /** Start stepping the round. It belongs to the thread until stop(). Does nothing while running. */
+    void start();
+
+    /** Stop after the step in progress and wait for it. The thread stops by itself once the round is over. */
+    void stop();
+
+    bool isRunning() const { return _thread.joinable(); }
+
+    /** Seconds of game time per step. */
+    float getStep() const { return _step; }
+
+    /** The newest published frame. Main thread only; valid until the next call. */
+    const RoundFrame& latest();
+
+    /** Hand every event pushed since the last call to `fn`, oldest first. Main thread only. */
+    template <typename Fn>
+    size_t drainEvents(Fn&& fn)
+    {
+        size_t count = 0;
+        Event event;
+        while (_events.pop(event))
+        {
+            fn(event);
+            ++count;
+        }
+        return count;
+    }
+
+    /** Events dropped because the main thread fell this far behind. */
+    uint32_t getDroppedEventCount() const { return _droppedEvents.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint8_t FRESH = 4;  // set in _shared when the slot it names was not read yet
+
+    void run();
+    void apply(const InputEvent& event);
+    void publish();
+    void addEvent(const Event& event);
+
+    GameRound& _round;
+    InputQueue& _input;
+    float _step;
+    StepHook _stepHook;
+    bool _suggestBotMoves;
+
+    std::array<RoundFrame, 3> _frames;
+    uint8_t _back;                 // written by the thread
+    std::atomic<uint8_t> _shared;  // slot index | FRESH, swapped by both sides
+    uint8_t _front;                // read by the main thread
+
+    // Held until the frame they belong to is published
+    std::array<Event, 64> _pending;
+    size_t _pendingCount;
+    SpscRing<Event, 256> _events;
+    std::atomic<uint32_t> _droppedEvents{0};
+
+    std::thread _thread;
+    std::atomic<bool> _stopping{false};
+    uint64_t _steps;
+};
@@ -0,0 +1,365 @@
+#include "SpriteBatchRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace
+{
+// Buffers start here and double, so a busy round settles after a few frames
+constexpr size_t INITIAL_CAPACITY = 64;
+
+// Compiled from Source/shaders; the fragment stage is the engine's own sprite shader
+constexpr std::string_view MOTION_VERTEX_SHADER   = "custom/spriteBatchMotion_vs";
+constexpr std::string_view MOTION_FRAGMENT_SHADER = "positionTextureColor_fs";
+}  // namespace
+
+SpriteBatchRenderer* SpriteBatchRenderer::create(std::string_view textureFile)
+{
+    auto texture = ax::Director::getInstance()->getTextureCache()->addImage(textureFile);
+    if (!texture)
+    {
+        return nullptr;
+    }
+
+    auto renderer = new SpriteBatchRenderer();
+    if (renderer->initWithTexture(texture))
+    {
+        renderer->autorelease();
+        return renderer;
+    }
+    delete renderer;
+    return nullptr;
+}
+
+SpriteBatchRenderer::SpriteBatchRenderer()
+    : _texture(nullptr)
+    , _programState(nullptr)
+    , _motionProgramState(nullptr)
+    , _blendFunc(ax::BlendFunc::ALPHA_PREMULTIPLIED)
+    , _instanceSize(ax::Size::ZERO)
+    , _bufferCapacity(0)
+    , _motionEnabled(false)
+    , _verticesDirty(true)
+    , _motionTime(0.0f)
+{}
+
+SpriteBatchRenderer::~SpriteBatchRenderer()
+{
+    AX_SAFE_RELEASE(_programState);
+    AX_SAFE_RELEASE(_motionProgramState);
+    AX_SAFE_RELEASE(_texture);
+}
+
+bool SpriteBatchRenderer::initWithTexture(ax::Texture2D* texture)
+{
+    if (!Node::init())
+    {
+        return false;
+    }
+
+    _texture = texture;
+    _texture->retain();
+    _instanceSize = _texture->getContentSize();
+    _blendFunc    = _texture->hasPremultipliedAlpha() ? ax::BlendFunc::ALPHA_PREMULTIPLIED
+                                                      : ax::BlendFunc::ALPHA_NON_PREMULTIPLIED;
+
+    auto program =
+        ax::ProgramManager::getInstance()->getBuiltinProgram(ax::backend::ProgramType::POSITION_TEXTURE_COLOR);
+    _programState = new ax::backend::ProgramState(program);
+    _programState->validateSharedVertexLayout(ax::backend::VertexLayoutType::Sprite);
+    _mvpMatrixLocation = _programState->getUniformLocation(ax::backend::Uniform::MVP_MATRIX);
+    _textureLocation   = _programState->getUniformLocation(ax::backend::Uniform::TEXTURE);
+    _programState->setTexture(_textureLocation, 0, _texture->getBackendTexture());
+
+    _customCommand.setDrawType(ax::CustomCommand::DrawType::ELEMENT);
+    _customCommand.setPrimitiveType(ax::CustomCommand::PrimitiveType::TRIANGLE);
+    _customCommand.getPipelineDescriptor().programState = _programState;
+
+    reserve(INITIAL_CAPACITY);
+    return true;
+}
+
+void SpriteBatchRenderer::setTexture(ax::Texture2D* texture)
+{
+    if (texture == _texture)
+    {
+        return;
+    }
+
+    AX_SAFE_RETAIN(texture);
+    AX_SAFE_RELEASE(_texture);
+    _texture      = texture;
+    _instanceSize = _texture->getContentSize();
+    _blendFunc    = _texture->hasPremultipliedAlpha() ? ax::BlendFunc::ALPHA_PREMULTIPLIED
+                                                      : ax::BlendFunc::ALPHA_NON_PREMULTIPLIED;
+    _programState->setTexture(_textureLocation, 0, _texture->getBackendTexture());
+    if (_motionProgramState)
+    {
+        _motionProgramState->setTexture(_motionTextureLocation, 0, _texture->getBackendTexture());
+    }
+    // The quads' corners depend on the instance size
+    _verticesDirty = true;
+}
+
+bool SpriteBatchRenderer::setMotionEnabled(bool enabled)
+{
+    if (enabled == _motionEnabled)
+    {
+        return true;
+    }
+
+    if (enabled && !_motionProgramState)
+    {
+        auto program = ax::ProgramManager::getInstance()->loadProgram(MOTION_VERTEX_SHADER, MOTION_FRAGMENT_SHADER);
+        if (!program)
+        {
+            AXLOGW("SpriteBatchRenderer: no motion shader, instances stay on the CPU");
+            return false;
+        }
+
+        _motionProgramState = new ax::backend::ProgramState(program);
+        auto layout         = _motionProgramState->getMutableVertexLayout();
+        layout->setAttrib("a_position", program->getAttributeLocation(ax::backend::Attribute::POSITION),
+                          ax::backend::VertexFormat::FLOAT3, offsetof(ax::V3F_C4B_T2F, vertices), false);
+        layout->setAttrib("a_color", program->getAttributeLocation(ax::backend::Attribute::COLOR),
+                          ax::backend::VertexFormat::UBYTE4, offsetof(ax::V3F_C4B_T2F, colors), true);
+        layout->setAttrib("a_texCoord", program->getAttributeLocation(ax::backend::Attribute::TEXCOORD),
+                          ax::backend::VertexFormat::FLOAT2, offsetof(ax::V3F_C4B_T2F, texCoords), false);
+        // Velocity and time are adjacent, so they go in as one vec3
+        layout->setAttrib("a_motion", program->getAttributeLocation("a_motion"), ax::backend::VertexFormat::FLOAT3,
+                          offsetof(MotionVertex, velocity), false);
+        layout->setStride(sizeof(MotionVertex));
+
+        _motionMvpMatrixLocation = _motionProgramState->getUniformLocation(ax::backend::Uniform::MVP_MATRIX);
+        _motionTextureLocation   = _motionProgramState->getUniformLocation(ax::backend::Uniform::TEXTURE);
+        _motionTimeLocation      = _motionProgramState->getUniformLocation("u_motionTime");
+        _motionProgramState->setTexture(_motionTextureLocation, 0, _texture->getBackendTexture());
+    }
+
+    _motionEnabled = enabled;
+    _customCommand.getPipelineDescriptor().programState = enabled ? _motionProgramState : _programState;
+
+    // The vertex size changed, so the buffers have to be made again
+    size_t capacity = _bufferCapacity;
+    _bufferCapacity = 0;
+    ensureBufferCapacity(capacity);
+    return true;
+}
+
+void SpriteBatchRenderer::reserve(size_t count)
+{
+    _instances.reserve(count);
+    _vertices.reserve(count * 4);
+    ensureBufferCapacity(count);
+}
+
+size_t SpriteBatchRenderer::add(const ax::Vec2& position, float rotation, float scale)
+{
+    _instances.push_back(Instance{position, rotation, scale, ax::Vec2::ZERO, 0.0f});
+    _verticesDirty = true;
+    return _instances.size() - 1;
+}
+
+void SpriteBatchRenderer::remove(size_t index)
+{
+    _instances[index] = _instances.back();
+    _instances.pop_back();
+    _verticesDirty = true;
+}
+
+// Only the new instances need writing; the draw simply stops short of dropped ones
+void SpriteBatchRenderer::resize(size_t count)
+{
+    size_t first = _instances.size();
+    _instances.resize(count, Instance{ax::Vec2::ZERO, 0.0f, 1.0f, ax::Vec2::ZERO, 0.0f});
+    for (size_t index = first; index < count; ++index)
+    {
+        invalidate(index);
+    }
+}
+
+// Past one entry per instance a full upload is cheaper, and the list stops growing while nothing draws
+void SpriteBatchRenderer::invalidate(size_t index)
+{
+    if (_verticesDirty)
+    {
+        return;
+    }
+    if (_dirtyInstances.size() >= _instances.size())
+    {
+        _dirtyInstances.clear();
+        _verticesDirty = true;
+        return;
+    }
+    _dirtyInstances.push_back(static_cast<uint32_t>(index));
+}
+
+ax::Rect SpriteBatchRenderer::getInstanceBox(size_t index) const
+{
+    const Instance& instance = _instances[index];
+    float width              = _instanceSize.width * instance.scale;
+    float height             = _instanceSize.height * instance.scale;
+    return ax::Rect(instance.position.x - width / 2, instance.position.y - height / 2, width, height);
+}
+
+// Quads never share vertices, so the index buffer only changes when it grows
+void SpriteBatchRenderer::ensureBufferCapacity(size_t count)
+{
+    if (count <= _bufferCapacity)
+    {
+        return;
+    }
+
+    size_t capacity   = std::max(_bufferCapacity * 2, std::max(count, INITIAL_CAPACITY));
+    size_t vertexSize = _motionEnabled ? sizeof(MotionVertex) : sizeof(ax::V3F_C4B_T2F);
+    _customCommand.createVertexBuffer(static_cast<unsigned int>(vertexSize), static_cast<unsigned int>(capacity * 4),
+                                      ax::CustomCommand::BufferUsage::DYNAMIC);
+    _customCommand.createIndexBuffer(ax::CustomCommand::IndexFormat::U_INT, static_cast<unsigned int>(capacity * 6),
+                                     ax::CustomCommand::BufferUsage::STATIC);
+
+    std::vector<uint32_t> indices(capacity * 6);
+    for (uint32_t quad = 0; quad < capacity; ++quad)
+    {
+        uint32_t first = quad * 4;
+        uint32_t* out  = &indices[quad * 6];
+        out[0]         = first;
+        out[1]         = first + 1;
+        out[2]         = first + 2;
+        out[3]         = first + 3;
+        out[4]         = first + 2;
+        out[5]         = first + 1;
+    }
+    _customCommand.updateIndexBuffer(indices.data(), static_cast<unsigned int>(indices.size() * sizeof(uint32_t)));
+    _bufferCapacity = capacity;
+    _verticesDirty  = true;
+}
+
+// Corner order per quad: bottom-left, bottom-right, top-left, top-right. A zero scale gives an empty quad.
+void SpriteBatchRenderer::buildQuad(const Instance& instance, ax::V3F_C4B_T2F* out) const
+{
+    const ax::Color32 white(255, 255, 255, 255);
+    float w             = _instanceSize.width / 2 * instance.scale;
+    float h             = _instanceSize.height / 2 * instance.scale;
+    ax::Vec2 corners[4] = {{-w, -h}, {w, -h}, {-w, h}, {w, h}};
+
+    if (instance.rotation != 0.0f)
+    {
+        float radians = -AX_DEGREES_TO_RADIANS(instance.rotation);
+        float c       = std::cos(radians);
+        float s       = std::sin(radians);
+        for (auto& corner : corners)
+        {
+            corner = ax::Vec2(corner.x * c - corner.y * s, corner.x * s + corner.y * c);
+        }
+    }
+
+    const ax::Tex2F texCoords[4] = {{0.0f, 1.0f}, {1.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f}};
+    for (int i = 0; i < 4; ++i)
+    {
+        out->vertices  = ax::Vec3(instance.position.x + corners[i].x, instance.position.y + corners[i].y, 0.0f);
+        out->colors    = white;
+        out->texCoords = texCoords[i];
+        ++out;
+    }
+}
+
+void SpriteBatchRenderer::buildVertices()
+{
+    _vertices.resize(_instances.size() * 4);
+    for (size_t i = 0; i < _instances.size(); ++i)
+    {
+        buildQuad(_instances[i], &_vertices[i * 4]);
+    }
+}
+
+// Every corner gets its instance's velocity and time; instanced attributes are not in every GL the engine runs on
+void SpriteBatchRenderer::uploadVertices()
+{
+    buildVertices();
+    if (!_motionEnabled)
+    {
+        _customCommand.updateVertexBuffer(_vertices.data(),
+                                          static_cast<unsigned int>(_vertices.size() * sizeof(ax::V3F_C4B_T2F)));
+        return;
+    }
+
+    _motionVertices.resize(_vertices.size());
+    for (size_t i = 0; i < _vertices.size(); ++i)
+    {
+        const Instance& instance = _instances[i / 4];
+        _motionVertices[i]       = MotionVertex{_vertices[i], instance.velocity, instance.time};
+    }
+    _customCommand.updateVertexBuffer(_motionVertices.data(),
+                                      static_cast<unsigned int>(_motionVertices.size() * sizeof(MotionVertex)));
+}
+
+// Rewrite only the invalidated quads, one upload per run of adjacent ones
+void SpriteBatchRenderer::uploadDirtyInstances()
+{
+    // Sorted into runs, without repeats or instances a resize has dropped since
+    std::sort(_dirtyInstances.begin(), _dirtyInstances.end());
+    _dirtyInstances.erase(std::unique(_dirtyInstances.begin(), _dirtyInstances.end()), _dirtyInstances.end());
+    _dirtyInstances.erase(std::lower_bound(_dirtyInstances.begin(), _dirtyInstances.end(), _instances.size()),
+                          _dirtyInstances.end());
+    _motionVertices.resize(_instances.size() * 4);
+
+    ax::V3F_C4B_T2F corners[4];
+    size_t runStart = 0;
+    for (size_t i = 0; i < _dirtyInstances.size(); ++i)
+    {
+        uint32_t index           = _dirtyInstances[i];
+        const Instance& instance = _instances[index];
+        buildQuad(instance, corners);
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            _motionVertices[index * 4 + corner] = MotionVertex{corners[corner], instance.velocity, instance.time};
+        }
+
+        if (i + 1 < _dirtyInstances.size() && _dirtyInstances[i + 1] == index + 1)
+        {
+            continue;
+        }
+        size_t first = _dirtyInstances[runStart];
+        _customCommand.updateVertexBuffer(&_motionVertices[first * 4],
+                                          static_cast<unsigned int>(first * 4 * sizeof(MotionVertex)),
+                                          static_cast<unsigned int>((index + 1 - first) * 4 * sizeof(MotionVertex)));
+        runStart = i + 1;
+    }
+}
+
+void SpriteBatchRenderer::draw(ax::Renderer* renderer, const ax::Mat4& transform, uint32_t flags)
+{
+    if (_instances.empty())
+    {
+        return;
+    }
+
+    ensureBufferCapacity(_instances.size());
+    // Without motion the instances may have moved through at() since the last frame
+    if (!_motionEnabled || _verticesDirty)
+    {
+        uploadVertices();
+        _verticesDirty = false;
+    }
+    else if (!_dirtyInstances.empty())
+    {
+        uploadDirtyInstances();
+    }
+    _dirtyInstances.clear();
+    _customCommand.setIndexDrawInfo(0, static_cast<unsigned int>(_instances.size() * 6));
+    _customCommand.init(_globalZOrder, _blendFunc);
+
+    const auto& projection = _director->getMatrix(ax::MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    ax::Mat4 mvp           = projection * transform;
+    if (_motionEnabled)
+    {
+        _motionProgramState->setUniform(_motionMvpMatrixLocation, mvp.m, sizeof(ax::Mat4::m));
+        _motionProgramState->setUniform(_motionTimeLocation, &_motionTime, sizeof(_motionTime));
+    }
+    else
+    {
+        _programState->setUniform(_mvpMatrixLocation, mvp.m, sizeof(ax::Mat4::m));
+    }
+    renderer->addCommand(&_customCommand);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "axmol/axmol.h"
+
+#include <vector>
+
+/**
+@brief  Draws many copies of one texture with a single draw call.
+
+Entities are plain Instance records in a packed array instead of Sprite nodes,
+so there is no per-entity transform update, visit or render command. Each frame
+the instances are expanded into one vertex buffer and submitted through a
+CustomCommand. Use one renderer per texture (bombs, collectibles, obstacles).
+
+Instances are centered on their position. remove() moves the last instance into
+the freed slot, so callers keeping parallel arrays must swap-pop them the same way.
+
+With motion enabled, instances that move at a constant velocity are moved by
+the vertex shader instead, from where they were at their own time to the
+current motion time. Only the instances passed to invalidate(index) are
+written again, so a caller that keeps dead slots in place (scale 0) instead of
+removing them uploads a few quads when something spawns or goes, and each
+other frame costs one setMotionTime().
+*/
+class SpriteBatchRenderer : public ax::Node
+{
+public:
+    struct Instance
+    {
+        ax::Vec2 position;
+        float rotation;  // degrees, clockwise like Node::setRotation()
+        float scale;
+        ax::Vec2 velocity;  // points per second; only drawn with motion enabled
+        float time;         // motion time at which the instance is at `position`
+    };
+
+    static SpriteBatchRenderer* create(std::string_view textureFile);
+
+    SpriteBatchRenderer();
+    ~SpriteBatchRenderer() override;
+
+    bool initWithTexture(ax::Texture2D* texture);
+
+    /** Draw every instance with `texture` from now on, e.g. the same image at another resolution. */
+    void setTexture(ax::Texture2D* texture);
+    ax::Texture2D* getTexture() const { return _texture; }
+
+    /**
+    @brief  Draw instances at `position + velocity * (motionTime - time)`, computed on the GPU.
+    @return false if the motion shader is not available; instances are then drawn where they are.
+    */
+    bool setMotionEnabled(bool enabled);
+    bool isMotionEnabled() const { return _motionEnabled; }
+
+    /** The clock the instances' times are on. */
+    void setMotionTime(float seconds) { _motionTime = seconds; }
+
+    /** With motion enabled, changes made through at() are only drawn after this, for every instance or one. */
+    void invalidate() { _verticesDirty = true; }
+    void invalidate(size_t index);
+
+    /** Grow CPU and GPU storage up front so adding up to `count` instances does not allocate. */
+    void reserve(size_t count);
+
+    size_t add(const ax::Vec2& position, float rotation = 0.0f, float scale = 1.0f);
+    void remove(size_t index);
+    void clear()
+    {
+        _instances.clear();
+        _verticesDirty = true;
+    }
+
+    /** Grow or shrink to `count` instances; new ones are unrotated, unscaled and still, at the origin. */
+    void resize(size_t count);
+
+    size_t size() const { return _instances.size(); }
+    bool empty() const { return _instances.empty(); }
+    Instance& at(size_t index) { return _instances[index]; }
+    const Instance& at(size_t index) const { return _instances[index]; }
+
+    /** Size of one unscaled instance, in points. */
+    const ax::Size& getInstanceSize() const { return _instanceSize; }
+
+    /** Axis-aligned box of an instance in this node's space; rotation is ignored. */
+    ax::Rect getInstanceBox(size_t index) const;
+
+    void draw(ax::Renderer* renderer, const ax::Mat4& transform, uint32_t flags) override;
+
+private:
+    struct MotionVertex
+    {
+        ax::V3F_C4B_T2F vertex;
+        ax::Vec2 velocity;
+        float time;
+    };
+
+    void ensureBufferCapacity(size_t count);
+    void buildQuad(const Instance& instance, ax::V3F_C4B_T2F* out) const;
+    void buildVertices();
+    void uploadVertices();
+    void uploadDirtyInstances();
+
+    ax::Texture2D* _texture;
+    ax::backend::ProgramState* _programState;
+    ax::backend::UniformLocation _mvpMatrixLocation;
+    ax::backend::UniformLocation _textureLocation;
+    ax::backend::ProgramState* _motionProgramState;  // created the first time motion is enabled
+    ax::backend::UniformLocation _motionMvpMatrixLocation;
+    ax::backend::UniformLocation _motionTextureLocation;
+    ax::backend::UniformLocation _motionTimeLocation;
+    ax::CustomCommand _customCommand;
+    ax::BlendFunc _blendFunc;
+    ax::Size _instanceSize;
+    std::vector<Instance> _instances;
+    std::vector<ax::V3F_C4B_T2F> _vertices;
+    std::vector<MotionVertex> _motionVertices;
+    std::vector<uint32_t> _dirtyInstances;  // with motion enabled, instances to write again at the next draw
+    size_t _bufferCapacity;  // instances the GPU buffers can hold
+    bool _motionEnabled;
+    bool _verticesDirty;  // with motion enabled, the vertex buffer no longer matches the instances
+    float _motionTime;
+};
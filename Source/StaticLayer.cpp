@@ -0,0 +1,170 @@
+#include "StaticLayer.h"
+
+#include <algorithm>
+
+uint64_t StaticLayer::s_totalPixelsSaved = 0;
+std::vector<StaticLayer*> StaticLayer::s_layers;
+
+StaticLayer* StaticLayer::create()
+{
+    return ax::utils::createInstance<StaticLayer>();
+}
+
+StaticLayer::StaticLayer()
+    : _renderTexture(nullptr)
+    , _cachedWinSize(ax::Size::ZERO)
+    , _pixelsSavedPerFrame(0)
+    , _cacheEnabled(true)
+    , _opaque(false)
+    , _dirty(true)
+{
+    s_layers.push_back(this);
+}
+
+StaticLayer::~StaticLayer()
+{
+    AX_SAFE_RELEASE(_renderTexture);
+    s_layers.erase(std::find(s_layers.begin(), s_layers.end(), this));
+}
+
+size_t StaticLayer::getResidentBytes()
+{
+    size_t bytes = 0;
+    for (auto layer : s_layers)
+    {
+        if (layer->_renderTexture)
+        {
+            const ax::Size& pixels = layer->_renderTexture->getSprite()->getTexture()->getContentSizeInPixels();
+            bytes += static_cast<size_t>(pixels.width) * static_cast<size_t>(pixels.height) * 4;
+        }
+    }
+    return bytes;
+}
+
+void StaticLayer::releaseAllCaches()
+{
+    for (auto layer : s_layers)
+    {
+        AX_SAFE_RELEASE_NULL(layer->_renderTexture);
+        layer->_dirty = true;
+    }
+}
+
+void StaticLayer::setAllCachesEnabled(bool enabled)
+{
+    for (auto layer : s_layers)
+    {
+        layer->setCacheEnabled(enabled);
+    }
+}
+
+void StaticLayer::setCacheEnabled(bool enabled)
+{
+    _cacheEnabled = enabled;
+    if (!enabled)
+    {
+        AX_SAFE_RELEASE_NULL(_renderTexture);
+        _pixelsSavedPerFrame = 0;
+    }
+    _dirty = true;
+}
+
+void StaticLayer::setOpaque(bool opaque)
+{
+    _opaque = opaque;
+    if (_renderTexture)
+    {
+        // The cache holds premultiplied colors, since it was cleared to transparent black
+        _renderTexture->getSprite()->setBlendFunc(opaque ? ax::BlendFunc::DISABLE : ax::BlendFunc::ALPHA_PREMULTIPLIED);
+    }
+}
+
+void StaticLayer::onEnterTransitionDidFinish()
+{
+    Node::onEnterTransitionDidFinish();
+    // Anything cached before now may have been drawn by the transition; start again from the layer at rest
+    invalidate();
+}
+
+void StaticLayer::visit(ax::Renderer* renderer, const ax::Mat4& parentTransform, uint32_t parentFlags)
+{
+    // A transition moves the scene every frame, so the children are drawn directly until it finishes. The cache
+    // was built under an identity parent, so the children's transforms are recomputed whenever they are drawn here.
+    if (!_cacheEnabled || dynamic_cast<ax::TransitionScene*>(_director->getRunningScene()))
+    {
+        Node::visit(renderer, parentTransform, parentFlags | FLAGS_TRANSFORM_DIRTY);
+        return;
+    }
+    if (!_visible)
+    {
+        return;
+    }
+
+    // Not an EVENT_PROJECTION_CHANGED listener: RenderTexture::begin() itself resets the projection
+    const ax::Size& winSize = _director->getWinSize();
+    if (_dirty || !_renderTexture || !winSize.equals(_cachedWinSize))
+    {
+        rebuild(renderer);
+    }
+
+    _renderTexture->visit(renderer, parentTransform, parentFlags);
+    s_totalPixelsSaved += _pixelsSavedPerFrame;
+}
+
+void StaticLayer::rebuild(ax::Renderer* renderer)
+{
+    const ax::Size& winSize = _director->getWinSize();
+    if (!_renderTexture || !winSize.equals(_cachedWinSize))
+    {
+        AX_SAFE_RELEASE(_renderTexture);
+        _renderTexture = ax::RenderTexture::create(static_cast<int>(winSize.width), static_cast<int>(winSize.height),
+                                                   ax::backend::PixelFormat::RGBA8);
+        AX_SAFE_RETAIN(_renderTexture);
+        _renderTexture->setPosition(winSize.width / 2, winSize.height / 2);
+        _cachedWinSize = winSize;
+        setOpaque(_opaque);
+    }
+
+    // Layer-local: visit() composites the cache under the parent transform, which must not be applied twice
+    _renderTexture->beginWithClear(0.0f, 0.0f, 0.0f, 0.0f);
+    Node::visit(renderer, ax::Mat4::IDENTITY, FLAGS_TRANSFORM_DIRTY);
+    _renderTexture->end();
+    _dirty = false;
+
+    float scale     = _director->getContentScaleFactor();
+    ax::Rect window = ax::Rect(ax::Vec2::ZERO, winSize);
+    float drawn     = measureDrawnPixels(this, window) * scale * scale;
+    float composite = winSize.width * winSize.height * scale * scale;
+
+    _pixelsSavedPerFrame = drawn > composite ? static_cast<uint32_t>(drawn - composite) : 0;
+
+    AXLOGI("StaticLayer cached {}x{} px, {} px less fill per frame", static_cast<int>(winSize.width * scale),
+           static_cast<int>(winSize.height * scale), _pixelsSavedPerFrame);
+}
+
+// On-screen area, in points, of the sprites and labels the cache replaces
+float StaticLayer::measureDrawnPixels(ax::Node* node, const ax::Rect& window) const
+{
+    float area = 0.0f;
+    for (auto child : node->getChildren())
+    {
+        if (!child->isVisible())
+        {
+            continue;
+        }
+
+        if (dynamic_cast<ax::Sprite*>(child) || dynamic_cast<ax::Label*>(child))
+        {
+            ax::Rect box = ax::RectApplyTransform(ax::Rect(ax::Vec2::ZERO, child->getContentSize()),
+                                                  child->getNodeToWorldTransform());
+            float width  = std::min(box.getMaxX(), window.getMaxX()) - std::max(box.getMinX(), window.getMinX());
+            float height = std::min(box.getMaxY(), window.getMaxY()) - std::max(box.getMinY(), window.getMinY());
+            if (width > 0.0f && height > 0.0f)
+            {
+                area += width * height;
+            }
+        }
+        area += measureDrawnPixels(child, window);
+    }
+    return area;
+}
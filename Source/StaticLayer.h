@@ -0,0 +1,68 @@
+#pragma once
+
+#include "axmol/axmol.h"
+
+#include <vector>
+
+/**
+@brief  Full-screen layer whose children are rendered once into a cached texture.
+
+Add backgrounds, titles and other nodes that never change to this layer instead
+of the scene. The first visit once the scene is at rest renders them into a
+window-sized render target; later frames draw that single quad. While a
+transition is running the children are drawn directly, since the transition
+moves them every frame. The cache is rebuilt when the window or
+design resolution changes, or when invalidate() is called after changing a child.
+Children must not animate and should not be interactive: they are only drawn
+on rebuilds.
+*/
+class StaticLayer : public ax::Node
+{
+public:
+    static StaticLayer* create();
+
+    StaticLayer();
+    ~StaticLayer() override;
+
+    /** Per-scene switch; disabled layers draw their children every frame like a plain Node. */
+    void setCacheEnabled(bool enabled);
+    bool isCacheEnabled() const { return _cacheEnabled; }
+
+    /** Composite without blending. Only valid when the children cover the whole screen. */
+    void setOpaque(bool opaque);
+
+    /** Redraw the children into the cache on the next visit. */
+    void invalidate() { _dirty = true; }
+
+    void onEnterTransitionDidFinish() override;
+    void visit(ax::Renderer* renderer, const ax::Mat4& parentTransform, uint32_t parentFlags) override;
+
+    /** Framebuffer pixels per frame this layer no longer shades, measured on the last rebuild. */
+    uint32_t getPixelsSavedPerFrame() const { return _pixelsSavedPerFrame; }
+
+    /** Pixels saved by all cached layers since launch. */
+    static uint64_t getTotalPixelsSaved() { return s_totalPixelsSaved; }
+
+    /** Bytes held by the render targets of all live layers. */
+    static size_t getResidentBytes();
+
+    /** Drop every layer's render target; each rebuilds on its next visit. */
+    static void releaseAllCaches();
+
+    /** setCacheEnabled() on every live layer, e.g. from the inspector. */
+    static void setAllCachesEnabled(bool enabled);
+
+private:
+    void rebuild(ax::Renderer* renderer);
+    float measureDrawnPixels(ax::Node* node, const ax::Rect& window) const;
+
+    static uint64_t s_totalPixelsSaved;
+    static std::vector<StaticLayer*> s_layers;
+
+    ax::RenderTexture* _renderTexture;
+    ax::Size _cachedWinSize;
+    uint32_t _pixelsSavedPerFrame;
+    bool _cacheEnabled;
+    bool _opaque;
+    bool _dirty;
+};
@@ -0,0 +1,190 @@
+#include "StressTest.h"
+#include "Percentile.h"
+
+#include <chrono>
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_LINUX
+#    include <sys/resource.h>
+#endif
+
+namespace
+{
+// Frames right after the bomb count changes are not representative
+constexpr uint64_t SETTLE_NS = 250'000'000;
+
+uint64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Peak resident set size in KiB, or 0 where we cannot tell
+long peakResidentKiB()
+{
+#if AX_TARGET_PLATFORM == AX_PLATFORM_LINUX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return usage.ru_maxrss;
+    }
+#endif
+    return 0;
+}
+}  // namespace
+
+StressTest::StressTest(const GameConfig& config)
+    : _config(config)
+    , _beforeUpdateListener(nullptr)
+    , _afterDrawListener(nullptr)
+    , _updateStart(0)
+    , _lastFrameEnd(0)
+    , _stepStart(nowNs())
+    , _targetBombs(config.stressStep)
+    , _sustainableBombs(0)
+    , _maxDrawCalls(0)
+    , _maxVertices(0)
+    , _finished(false)
+{
+    auto dispatcher       = ax::Director::getInstance()->getEventDispatcher();
+    _beforeUpdateListener = dispatcher->addCustomEventListener(ax::Director::EVENT_BEFORE_UPDATE,
+                                                               [this](ax::EventCustom*) { onBeforeUpdate(); });
+    _afterDrawListener =
+        dispatcher->addCustomEventListener(ax::Director::EVENT_AFTER_DRAW, [this](ax::EventCustom*) { onAfterDraw(); });
+
+    AXLOGI("Stress mode: +{} bombs every {}s until p95 frame work exceeds {} ms", _config.stressStep,
+           _config.stressStepSeconds, _config.stressBudgetMs);
+}
+
+StressTest::~StressTest()
+{
+    auto dispatcher = ax::Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_beforeUpdateListener);
+    dispatcher->removeEventListener(_afterDrawListener);
+}
+
+void StressTest::onBeforeUpdate()
+{
+    _updateStart = nowNs();
+}
+
+void StressTest::onAfterDraw()
+{
+    if (_finished)
+    {
+        return;
+    }
+
+    uint64_t now = nowNs();
+    if (_updateStart != 0 && _lastFrameEnd != 0 && now - _stepStart >= SETTLE_NS)
+    {
+        _workSamples.push_back(static_cast<float>(now - _updateStart) / 1.0e6f);
+        _frameSamples.push_back(static_cast<float>(now - _lastFrameEnd) / 1.0e6f);
+
+        auto renderer = ax::Director::getInstance()->getRenderer();
+        _maxDrawCalls = std::max(_maxDrawCalls, static_cast<uint32_t>(renderer->getDrawnBatches()));
+        _maxVertices  = std::max(_maxVertices, static_cast<uint32_t>(renderer->getDrawnVertices()));
+    }
+    _lastFrameEnd = now;
+
+    if (static_cast<float>(now - _stepStart) / 1.0e9f >= _config.stressStepSeconds)
+    {
+        endStep(now);
+    }
+}
+
+void StressTest::endStep(uint64_t now)
+{
+    Step step;
+    step.bombs        = _targetBombs;
+    step.frames       = static_cast<uint32_t>(_workSamples.size());
+    step.workP99      = percentileOf(_workSamples, 0.99f);
+    step.workP95      = percentileOf(_workSamples, 0.95f);
+    step.workP50      = percentileOf(_workSamples, 0.50f);
+    step.frameP99     = percentileOf(_frameSamples, 0.99f);
+    step.frameP95     = percentileOf(_frameSamples, 0.95f);
+    step.frameP50     = percentileOf(_frameSamples, 0.50f);
+    step.maxDrawCalls = _maxDrawCalls;
+    step.maxVertices  = _maxVertices;
+    _steps.push_back(step);
+
+    AXLOGI("Stress step {} bombs: work p50 {:.2f} p95 {:.2f} p99 {:.2f} ms, {} draw calls", step.bombs, step.workP50,
+           step.workP95, step.workP99, step.maxDrawCalls);
+
+    _workSamples.clear();
+    _frameSamples.clear();
+    _maxDrawCalls = 0;
+    _maxVertices  = 0;
+    _stepStart    = now;
+
+    if (step.frames == 0)
+    {
+        return;
+    }
+    if (step.workP95 > _config.stressBudgetMs)
+    {
+        finish("frame budget exceeded");
+        return;
+    }
+
+    _sustainableBombs = step.bombs;
+    if (_targetBombs + _config.stressStep > _config.stressMaxBombs)
+    {
+        finish("bomb cap reached");
+        return;
+    }
+    _targetBombs += _config.stressStep;
+}
+
+void StressTest::finish(const char* reason)
+{
+    _finished = true;
+    if (!writeReport(reason))
+    {
+        AXLOGE("Failed to write the stress report");
+    }
+    ax::Director::getInstance()->end();
+}
+
+bool StressTest::writeReport(const char* reason) const
+{
+    auto fileUtils   = ax::FileUtils::getInstance();
+    std::string path = _config.stressReport.empty() ? fileUtils->getWritablePath() + "stress_report.txt"
+                                                    : _config.stressReport;
+
+    const Step* best = nullptr;
+    for (const auto& step : _steps)
+    {
+        if (step.bombs == _sustainableBombs)
+        {
+            best = &step;
+        }
+    }
+
+    std::string report;
+    report += ax::StringUtils::format("stopped: %s\n", reason);
+    report += ax::StringUtils::format("budget_ms: %.2f\n", _config.stressBudgetMs);
+    report += ax::StringUtils::format("max_sustainable_bombs: %u\n", _sustainableBombs);
+    if (best)
+    {
+        report += ax::StringUtils::format("work_ms p50 %.2f p95 %.2f p99 %.2f\n", best->workP50, best->workP95,
+                                          best->workP99);
+        report += ax::StringUtils::format("frame_ms p50 %.2f p95 %.2f p99 %.2f\n", best->frameP50, best->frameP95,
+                                          best->frameP99);
+        report += ax::StringUtils::format("draw_calls: %u\n", best->maxDrawCalls);
+    }
+    report += ax::StringUtils::format("peak_rss_kib: %ld\n", peakResidentKiB());
+    report += ax::StringUtils::format("config: spawn-interval %.2f wave-size %u speed %.0f-%.0f\n",
+                                      _config.spawnInterval, _config.waveSize, _config.minSpeed, _config.maxSpeed);
+
+    report += "\nbombs frames work_p50 work_p95 work_p99 frame_p50 frame_p95 frame_p99 draw_calls vertices\n";
+    for (const auto& step : _steps)
+    {
+        report += ax::StringUtils::format("%u %u %.2f %.2f %.2f %.2f %.2f %.2f %u %u\n", step.bombs, step.frames,
+                                          step.workP50, step.workP95, step.workP99, step.frameP50, step.frameP95,
+                                          step.frameP99, step.maxDrawCalls, step.maxVertices);
+    }
+
+    AXLOGI("Stress report written to {}\n{}", path, report);
+    return fileUtils->writeStringToFile(report, path);
+}
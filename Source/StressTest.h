@@ -0,0 +1,59 @@
+#pragma once
+
+#include "axmol/axmol.h"
+#include "GameConfig.h"
+
+#include <atomic>
+#include <vector>
+
+/**
+@brief  Soak test that ramps the bomb count until the frame budget is exceeded.
+
+MainScene keeps getTargetBombs() bombs alive. Every `stress-step-seconds` the
+step's frame work time (update start to end of draw) is measured. While its p95
+stays within `stress-budget-ms` the target grows by `stress-step`. Once it is
+exceeded, the report is written and the Director ends, so the run can be
+unattended.
+*/
+class StressTest
+{
+public:
+    explicit StressTest(const GameConfig& config);
+    ~StressTest();
+
+    /** Safe from the threaded-sim thread while the main thread ramps it. */
+    uint32_t getTargetBombs() const { return _targetBombs.load(std::memory_order_relaxed); }
+    bool isFinished() const { return _finished; }
+
+private:
+    struct Step
+    {
+        uint32_t bombs;
+        uint32_t frames;
+        float workP50, workP95, workP99;
+        float frameP50, frameP95, frameP99;
+        uint32_t maxDrawCalls;
+        uint32_t maxVertices;
+    };
+
+    void onBeforeUpdate();
+    void onAfterDraw();
+    void endStep(uint64_t now);
+    void finish(const char* reason);
+    bool writeReport(const char* reason) const;
+
+    const GameConfig& _config;
+    ax::EventListenerCustom* _beforeUpdateListener;
+    ax::EventListenerCustom* _afterDrawListener;
+    std::vector<Step> _steps;
+    std::vector<float> _workSamples;
+    std::vector<float> _frameSamples;
+    uint64_t _updateStart;
+    uint64_t _lastFrameEnd;
+    uint64_t _stepStart;
+    std::atomic<uint32_t> _targetBombs;
+    uint32_t _sustainableBombs;
+    uint32_t _maxDrawCalls;
+    uint32_t _maxVertices;
+    bool _finished;
+};
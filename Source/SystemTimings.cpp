@@ -0,0 +1,37 @@
+#include "SystemTimings.h"
+
+#if HAPPY_INSPECTOR
+
+std::atomic<bool> SystemTimings::s_enabled{false};
+std::array<std::atomic<uint64_t>, SystemTimings::COUNT> SystemTimings::s_totals{};
+
+const char* SystemTimings::getName(System system)
+{
+    switch (system)
+    {
+    case System::Update:
+        return "update";
+    case System::Collision:
+        return "collision";
+    case System::Spawn:
+        return "spawn";
+    case System::Particles:
+        return "particles";
+    case System::Audio:
+        return "audio";
+    default:
+        return "?";
+    }
+}
+
+std::array<uint64_t, SystemTimings::COUNT> SystemTimings::take()
+{
+    std::array<uint64_t, COUNT> totals;
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        totals[i] = s_totals[i].exchange(0, std::memory_order_relaxed);
+    }
+    return totals;
+}
+
+#endif
@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+@brief  Time spent per game system, for the inspector overlay. Built with the inspector only.
+
+Mark code with PERF_SCOPE(SystemTimings::System::...); the macro compiles to
+nothing without HAPPY_INSPECTOR. Scopes may run on any thread (collision on the
+threaded sim, decoding on the music thread), so totals are atomics that the
+inspector takes once per frame. While nobody is looking a scope costs one
+relaxed load, so the batch simulator's cores do not fight over the counters.
+*/
+#if HAPPY_INSPECTOR
+
+#    include <array>
+#    include <atomic>
+#    include <chrono>
+#    include <cstdint>
+
+class SystemTimings
+{
+public:
+    enum class System
+    {
+        Update,     // the scene's whole update
+        Collision,  // the earliest hit and the bombs that left the field
+        Spawn,      // wave and score scripts
+        Particles,  // creating explosions
+        Audio,      // starting effects and decoding music
+        Count
+    };
+
+    static constexpr size_t COUNT = static_cast<size_t>(System::Count);
+
+    static const char* getName(System system);
+
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    static void add(System system, uint64_t ns)
+    {
+        s_totals[static_cast<size_t>(system)].fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    /** Nanoseconds per system since the last call. */
+    static std::array<uint64_t, COUNT> take();
+
+private:
+    static std::atomic<bool> s_enabled;
+    static std::array<std::atomic<uint64_t>, COUNT> s_totals;
+};
+
+class SystemTimer
+{
+public:
+    explicit SystemTimer(SystemTimings::System system) : _system(system), _running(SystemTimings::isEnabled())
+    {
+        if (_running)
+        {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+    ~SystemTimer()
+    {
+        if (_running)
+        {
+            auto elapsed = std::chrono::steady_clock::now() - _start;
+            SystemTimings::add(_system, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+    SystemTimer(const SystemTimer&)            = delete;
+    SystemTimer& operator=(const SystemTimer&) = delete;
+
+private:
+    SystemTimings::System _system;
+    bool _running;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#    define PERF_SCOPE_CONCAT2(a, b) a##b
+#    define PERF_SCOPE_CONCAT(a, b)  PERF_SCOPE_CONCAT2(a, b)
+#    define PERF_SCOPE(system)       SystemTimer PERF_SCOPE_CONCAT(systemTimer, __LINE__)(system)
+
+#else
+
+#    define PERF_SCOPE(system)
+
+#endif
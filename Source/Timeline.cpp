@@ -0,0 +1,167 @@
+#include "Timeline.h"
+#include "axmol/axmol.h"
+
+#include <new>
+
+namespace
+{
+// Room for the scripts' waits without growing the lists mid-frame
+constexpr size_t WAITER_RESERVE = 32;
+
+constexpr size_t alignUp(size_t bytes)
+{
+    return (bytes + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+}
+}  // namespace
+
+Timeline::Timeline(size_t arenaBytes)
+    : _arena(new std::max_align_t[alignUp(arenaBytes) / sizeof(std::max_align_t)])
+    , _arenaBytes(alignUp(arenaBytes))
+    , _arenaUsed(0)
+    , _free(nullptr)
+    , _time(0.0)
+    , _now(0.0)
+    , _delta(0.0f)
+    , _warnedFull(false)
+{
+    _roots.reserve(WAITER_RESERVE);
+    _timed.reserve(WAITER_RESERVE);
+    _framed.reserve(WAITER_RESERVE);
+    _resuming.reserve(WAITER_RESERVE);
+}
+
+Timeline::~Timeline()
+{
+    // The frames live in the arena, so they have to go first
+    clear();
+}
+
+void* Timeline::allocate(size_t size)
+{
+    size_t bytes = alignUp(sizeof(Block) + size);
+
+    // Instances of one script all have the same frame size, so a finished one's block fits the next
+    for (Block** link = &_free; *link; link = &(*link)->next)
+    {
+        if ((*link)->bytes >= bytes)
+        {
+            Block* block = *link;
+            *link        = block->next;
+            return block + 1;
+        }
+    }
+
+    Block* block;
+    if (_arenaUsed + bytes <= _arenaBytes)
+    {
+        block = reinterpret_cast<Block*>(reinterpret_cast<char*>(_arena.get()) + _arenaUsed);
+        _arenaUsed += bytes;
+        block->owner = this;
+    }
+    else
+    {
+        if (!_warnedFull)
+        {
+            AXLOGW("Timeline: arena of {} bytes is full, script frames now come from the heap", _arenaBytes);
+            _warnedFull = true;
+        }
+        block        = static_cast<Block*>(::operator new(bytes, std::align_val_t{alignof(Block)}));
+        block->owner = nullptr;
+    }
+    block->next  = nullptr;
+    block->bytes = bytes;
+    return block + 1;
+}
+
+void Timeline::deallocate(void* frame)
+{
+    Block* block = static_cast<Block*>(frame) - 1;
+    if (!block->owner)
+    {
+        ::operator delete(block, std::align_val_t{alignof(Block)});
+        return;
+    }
+    block->next         = block->owner->_free;
+    block->owner->_free = block;
+}
+
+void Timeline::start(Task task)
+{
+    auto handle  = task._handle;
+    task._handle = nullptr;
+    _roots.push_back(handle);
+
+    auto previous = _now;
+    _now          = _time;
+    handle.resume();
+    _now = previous;
+}
+
+void Timeline::advance(float dt)
+{
+    _delta = dt;
+    _time += dt;
+    _now = _time;
+
+    // Frame waits were all parked during an earlier advance; the ones parked now wait for the next
+    _resuming.swap(_framed);
+    for (const Waiter& waiter : _resuming)
+    {
+        if (!waiter.ready || waiter.ready(waiter.context))
+        {
+            waiter.handle.resume();
+        }
+        else
+        {
+            _framed.push_back(waiter);
+        }
+    }
+    _resuming.clear();
+
+    // Earliest deadline first; a script that waits again may still be due within this advance
+    for (;;)
+    {
+        size_t next = _timed.size();
+        for (size_t i = 0; i < _timed.size(); ++i)
+        {
+            if (_timed[i].deadline <= _time && (next == _timed.size() || _timed[i].deadline < _timed[next].deadline))
+            {
+                next = i;
+            }
+        }
+        if (next == _timed.size())
+        {
+            break;
+        }
+
+        Waiter waiter = _timed[next];
+        _timed.erase(_timed.begin() + next);
+        _now = waiter.deadline;
+        waiter.handle.resume();
+    }
+    _now = _time;
+
+    for (size_t i = 0; i < _roots.size();)
+    {
+        if (_roots[i].done())
+        {
+            _roots[i].destroy();
+            _roots[i] = _roots.back();
+            _roots.pop_back();
+            continue;
+        }
+        ++i;
+    }
+}
+
+void Timeline::clear()
+{
+    // Destroying a script also destroys the scripts it is awaiting, which live in its frame
+    for (auto root : _roots)
+    {
+        root.destroy();
+    }
+    _roots.clear();
+    _timed.clear();
+    _framed.clear();
+}
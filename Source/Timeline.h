@@ -0,0 +1,231 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+@brief  Runs C++20 coroutine scripts against game time, with their frames in an arena.
+
+A script is a coroutine returning Timeline::Task that takes a `Timeline&`
+parameter; its frame is carved out of that timeline's arena instead of the heap.
+Inside it, `co_await` one of:
+
+    timeline.seconds(s)       resume s seconds of game time later
+    timeline.at(t)            resume once game time reaches t
+    timeline.nextFrame()      resume on the next advance()
+    timeline.until(predicate) resume on the first advance() where predicate() holds
+    someTask(timeline, ...)   run another script to its end, e.g. a wave
+
+Nothing runs by itself: the owner calls advance() with its frame or step time,
+so the same scripts work under the scheduler and headless. Timed waits are
+resumed in deadline order and keep the exact deadline as now(), so a script
+waiting in a loop does not drift, and catches up if one step spans several
+deadlines. Frames freed by finished scripts are reused, so a timeline that
+runs the same scripts over and over stops allocating after the first run.
+*/
+class Timeline
+{
+public:
+    class Task;
+
+    /** `arenaBytes` is room for the coroutine frames alive at once; more is taken from the heap. */
+    explicit Timeline(size_t arenaBytes = 4 * 1024);
+    ~Timeline();
+
+    Timeline(const Timeline&)            = delete;
+    Timeline& operator=(const Timeline&) = delete;
+
+    /** Run `task` up to its first wait. The timeline owns it from then on. */
+    void start(Task task);
+
+    /** Move game time forward by `dt` seconds and resume every script that is due. */
+    void advance(float dt);
+
+    /** Destroy every script. Not from inside a script of this timeline. */
+    void clear();
+
+    /** Set game time, e.g. before restarting saved scripts. Only after clear(). */
+    void setTime(double time) { _time = _now = time; }
+
+    /** Game time in seconds; inside a script resumed by seconds(), the moment it was due. */
+    double now() const { return _now; }
+
+    /** The `dt` of the advance() in progress, or of the last one. */
+    float getDelta() const { return _delta; }
+
+    bool isIdle() const { return _roots.empty(); }
+
+    auto seconds(float seconds) { return DeadlineAwaiter{*this, _now + seconds}; }
+
+    /** Waiting for an absolute time keeps a script exact across save and restore, where a delay would round. */
+    auto at(double time) { return DeadlineAwaiter{*this, time}; }
+    auto nextFrame() { return FrameAwaiter{*this}; }
+
+    template <typename Predicate>
+    auto until(Predicate predicate)
+    {
+        return UntilAwaiter<Predicate>{*this, std::move(predicate)};
+    }
+
+private:
+    struct alignas(std::max_align_t) Block
+    {
+        Timeline* owner;  // nullptr once the arena was full and the block came from the heap
+        Block* next;      // free list
+        size_t bytes;     // including this header
+    };
+
+    struct Waiter
+    {
+        std::coroutine_handle<> handle;
+        double deadline;
+        bool (*ready)(void*);  // until(): the awaiter's check, null for the other waits
+        void* context;
+    };
+
+    struct DeadlineAwaiter
+    {
+        Timeline& timeline;
+        double deadline;
+
+        bool await_ready() const noexcept { return deadline <= timeline._now; }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            timeline._timed.push_back(Waiter{handle, deadline, nullptr, nullptr});
+        }
+        void await_resume() const noexcept {}
+    };
+
+    struct FrameAwaiter
+    {
+        Timeline& timeline;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            timeline._framed.push_back(Waiter{handle, 0.0, nullptr, nullptr});
+        }
+        void await_resume() const noexcept {}
+    };
+
+    // Lives in the waiting coroutine's frame until it resumes, so the predicate is stored without allocating
+    template <typename Predicate>
+    struct UntilAwaiter
+    {
+        Timeline& timeline;
+        Predicate predicate;
+
+        bool await_ready() { return predicate(); }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            timeline._framed.push_back(Waiter{handle, 0.0, &UntilAwaiter::check, this});
+        }
+        void await_resume() const noexcept {}
+
+        static bool check(void* self) { return static_cast<UntilAwaiter*>(self)->predicate(); }
+    };
+
+    void* allocate(size_t size);
+    static void deallocate(void* frame);
+
+    template <typename First, typename... Rest>
+    static Timeline& findTimeline(First& first, Rest&... rest)
+    {
+        if constexpr (std::is_same_v<std::remove_cv_t<First>, Timeline>)
+        {
+            return first;
+        }
+        else
+        {
+            static_assert(sizeof...(Rest) > 0, "A Timeline::Task coroutine needs a Timeline& parameter for its frame");
+            return findTimeline(rest...);
+        }
+    }
+
+    std::unique_ptr<std::max_align_t[]> _arena;
+    size_t _arenaBytes;
+    size_t _arenaUsed;
+    Block* _free;
+    std::vector<std::coroutine_handle<>> _roots;
+    std::vector<Waiter> _timed;
+    std::vector<Waiter> _framed;
+    std::vector<Waiter> _resuming;
+    double _time;
+    double _now;
+    float _delta;
+    bool _warnedFull;
+};
+
+/** What a timeline script returns. Awaiting one runs it and resumes the caller when it ends. */
+class Timeline::Task
+{
+public:
+    struct promise_type
+    {
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                {
+                    auto continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+                void await_resume() const noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        template <typename... Args>
+        static void* operator new(size_t size, Args&... args)
+        {
+            return findTimeline(args...).allocate(size);
+        }
+        static void operator delete(void* frame) { Timeline::deallocate(frame); }
+    };
+
+    Task(Task&& other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+    Task& operator=(Task&&) = delete;
+    ~Task()
+    {
+        if (_handle)
+        {
+            _handle.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> child;
+
+            bool await_ready() const noexcept { return child.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> parent) noexcept
+            {
+                child.promise().continuation = parent;
+                return child;
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{_handle};
+    }
+
+private:
+    friend class Timeline;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+    std::coroutine_handle<promise_type> _handle;
+};
@@ -0,0 +1,89 @@
+#include "VersusBench.h"
+#include "RollbackSession.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+// The design resolution and the high tier's sprite sizes, in points, as BatchSim plays them
+const ax::Size FIELD_SIZE(768, 1280);
+const ax::Size PLAYER_SIZE(130, 253);
+const ax::Size BOMB_SIZE(92, 120);
+
+constexpr uint64_t FRAME_US = 1000000 / 60;
+}  // namespace
+
+VersusBench::VersusBench(const GameConfig& config) : _config(config) {}
+
+bool VersusBench::run()
+{
+    std::unique_ptr<VersusTransport> transports[VersusRound::PLAYERS];
+    if (!VersusTransport::createPair(_config, transports[0], transports[1]))
+    {
+        return false;
+    }
+
+    const uint64_t seed = _config.seed ? _config.seed : 1;
+    const auto settings = RollbackSession::Settings::fromConfig(_config);
+    VersusRound rounds[VersusRound::PLAYERS];
+    for (auto& round : rounds)
+    {
+        round.setup(GameRules::fromConfig(_config), FIELD_SIZE, PLAYER_SIZE, BOMB_SIZE, seed);
+        round.reset();
+    }
+    RollbackSession sessions[VersusRound::PLAYERS] = {{rounds[0], *transports[0], 0, settings},
+                                                      {rounds[1], *transports[1], 1, settings}};
+    VersusBot bots[VersusRound::PLAYERS] = {{0, _config.simBotSkill, ~seed}, {1, _config.simBotSkill, seed * 31}};
+
+    printf("Playing %u versus frames over %s, %.0f ms latency, %.0f ms jitter, %.1f%% loss\n", _config.versusFrames,
+           _config.versusTransport.c_str(), _config.versusLatencyMs, _config.versusJitterMs,
+           _config.versusLoss * 100.0f);
+
+    uint32_t matches = 0, disagreements = 0;
+    uint64_t nowUs = 0;
+    auto start     = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < _config.versusFrames; ++frame, nowUs += FRAME_US)
+    {
+        for (int player = 0; player < VersusRound::PLAYERS; ++player)
+        {
+            sessions[player].advance(bots[player].next(rounds[player]), nowUs);
+        }
+
+        if (sessions[0].isDecided() && sessions[1].isDecided())
+        {
+            ++matches;
+            if (rounds[0].getWinner() != rounds[1].getWinner())
+            {
+                ++disagreements;
+            }
+            for (int player = 0; player < VersusRound::PLAYERS; ++player)
+            {
+                rounds[player].reset();
+                sessions[player].reset();
+            }
+        }
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::string report;
+    report += ax::StringUtils::format("frames: %u\n", _config.versusFrames);
+    report += ax::StringUtils::format("wall_seconds: %.2f\n", wallSeconds);
+    report += ax::StringUtils::format("transport: %s latency_ms: %.1f jitter_ms: %.1f loss: %.3f\n",
+                                      _config.versusTransport.c_str(), _config.versusLatencyMs,
+                                      _config.versusJitterMs, _config.versusLoss);
+    report += ax::StringUtils::format("matches: %u winner_disagreements: %u\n", matches, disagreements);
+    for (const auto& session : sessions)
+    {
+        report += "\n" + session.buildReport();
+    }
+
+    auto fileUtils   = ax::FileUtils::getInstance();
+    std::string path = _config.versusReport.empty() ? fileUtils->getWritablePath() + "versus_report.txt"
+                                                    : _config.versusReport;
+    printf("%s\nVersus report written to %s\n", report.c_str(), path.c_str());
+    fileUtils->writeStringToFile(report, path);
+
+    return disagreements == 0 && sessions[0].getDesyncCount() == 0 && sessions[1].getDesyncCount() == 0;
+}
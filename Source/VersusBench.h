@@ -0,0 +1,27 @@
+#pragma once
+
+#include "GameConfig.h"
+
+/**
+@brief  Plays versus matches between two bot peers headless, to measure and check the rollback session.
+
+Both peers run in this process on one thread, each with its own VersusRound
+and RollbackSession, connected by the `versus-transport` under the simulated
+latency, jitter and loss. Time is simulated too, one display frame per
+iteration, so `versus-frames` frames take as long as the CPU needs, not as
+long as they would on screen. Finished matches restart until the frames are up.
+
+The report has both sessions' resimulation cost, rollback depths and stalls,
+and whether the peers ever disagreed on a confirmed frame or on who won.
+*/
+class VersusBench
+{
+public:
+    explicit VersusBench(const GameConfig& config);
+
+    /** Play and write the report. @return false on a desync or when the transport cannot be set up. */
+    bool run();
+
+private:
+    const GameConfig& _config;
+};
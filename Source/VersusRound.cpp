@@ -0,0 +1,178 @@
+#include "VersusRound.h"
+
+#include <cmath>
+
+namespace
+{
+// About as often as MainScene's autoplay moves
+constexpr uint32_t BOT_FRAMES = 6;
+
+int16_t toPoints(float value)
+{
+    return static_cast<int16_t>(std::lround(value));
+}
+
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+}  // namespace
+
+void VersusRound::setup(const GameRules& rules, const ax::Size& field, const ax::Size& playerSize,
+                        const ax::Size& bombSize, uint64_t seed)
+{
+    // A match has to end somehow
+    GameRules versusRules    = rules;
+    versusRules.invulnerable = false;
+
+    for (auto& round : _rounds)
+    {
+        round.setRules(versusRules);
+        round.setField(field, playerSize, bombSize);
+        round.reserve(64);
+    }
+    _seed       = seed;
+    _fieldWidth = field.width;
+}
+
+void VersusRound::reset()
+{
+    for (int player = 0; player < PLAYERS; ++player)
+    {
+        GameRound& round = _rounds[player];
+        round.setSeed(_seed);
+        round.reset(true);
+        // Side by side rather than on top of each other
+        round.movePlayerTo(round.getPlayerPosition().x + (player == 0 ? -0.25f : 0.25f) * _fieldWidth);
+    }
+    _frame    = 0;
+    _endFrame = 0;
+}
+
+void VersusRound::step(const std::array<VersusInput, PLAYERS>& inputs)
+{
+    if (isOver())
+    {
+        // Frames keep counting, so a rollback session can go on confirming how the match ended
+        ++_frame;
+        return;
+    }
+
+    for (int player = 0; player < PLAYERS; ++player)
+    {
+        const VersusInput& input = inputs[player];
+        if (input.flags & VersusInput::TAP)
+        {
+            // The bombs are shared, so both rounds lose them
+            for (auto& round : _rounds)
+            {
+                round.tap(ax::Vec2(input.tapX, input.tapY));
+            }
+        }
+        if (input.flags & VersusInput::DRAG)
+        {
+            _rounds[player].dragPlayer(ax::Vec2(input.dragX, input.dragY));
+        }
+        if (input.tilt != 0)
+        {
+            _rounds[player].tiltPlayer(input.tilt / 1000.0f);
+        }
+    }
+
+    for (auto& round : _rounds)
+    {
+        round.step(STEP);
+    }
+    ++_frame;
+    if (isOver())
+    {
+        _endFrame = _frame;
+    }
+}
+
+int VersusRound::getWinner() const
+{
+    bool over0 = _rounds[0].isOver();
+    bool over1 = _rounds[1].isOver();
+    if (over0 == over1)
+    {
+        return -1;
+    }
+    return over0 ? 1 : 0;
+}
+
+VersusInput VersusRound::suggestBotInput(int player) const
+{
+    GameRound::BotMove move = _rounds[player].suggestBotMove();
+    VersusInput input;
+    if (move.tap)
+    {
+        input.flags |= VersusInput::TAP;
+        input.tapX = toPoints(move.tapAt.x);
+        input.tapY = toPoints(move.tapAt.y);
+    }
+    if (move.drag)
+    {
+        input.flags |= VersusInput::DRAG;
+        input.dragX = toPoints(move.dragTo.x);
+        input.dragY = toPoints(move.dragTo.y);
+    }
+    return input;
+}
+
+void VersusRound::save(State& state) const
+{
+    for (int player = 0; player < PLAYERS; ++player)
+    {
+        _rounds[player].saveState(state.rounds[player]);
+    }
+    state.frame    = _frame;
+    state.endFrame = _endFrame;
+}
+
+void VersusRound::restore(const State& state)
+{
+    for (int player = 0; player < PLAYERS; ++player)
+    {
+        _rounds[player].restoreState(state.rounds[player]);
+    }
+    _frame    = state.frame;
+    _endFrame = state.endFrame;
+}
+
+uint64_t VersusRound::checksum() const
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash          = hashBytes(hash, &_frame, sizeof(_frame));
+    hash          = hashBytes(hash, &_endFrame, sizeof(_endFrame));
+    for (const auto& round : _rounds)
+    {
+        round.forEachBomb([&hash](const ax::Vec2& position, float speed) {
+            hash = hashBytes(hash, &position, sizeof(position));
+            hash = hashBytes(hash, &speed, sizeof(speed));
+        });
+        uint64_t rngState = round.getRng().getState();
+        int score         = round.getScore();
+        bool over         = round.isOver();
+        hash              = hashBytes(hash, &round.getPlayerPosition(), sizeof(ax::Vec2));
+        hash                  = hashBytes(hash, &rngState, sizeof(rngState));
+        hash                  = hashBytes(hash, &score, sizeof(score));
+        hash                  = hashBytes(hash, &over, sizeof(over));
+    }
+    return hash;
+}
+
+VersusInput VersusBot::next(const VersusRound& round)
+{
+    if (++_frames < BOT_FRAMES)
+    {
+        return VersusInput{};
+    }
+    _frames = 0;
+    return _rng.next01() < _skill ? round.suggestBotInput(_player) : VersusInput{};
+}
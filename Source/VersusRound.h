@@ -0,0 +1,111 @@
+#pragma once
+
+#include "axmol/axmol.h"
+#include "GameRound.h"
+#include "Rng.h"
+
+#include <array>
+
+/**
+@brief  One frame of a versus player's input, small and exact enough to send every frame.
+
+Positions are whole points and tilt is in thousandths of g, so both peers apply
+the very same numbers.
+*/
+struct VersusInput
+{
+    enum Flags : uint8_t
+    {
+        TAP  = 1,
+        DRAG = 2,
+    };
+
+    uint8_t flags = 0;
+    int16_t tapX  = 0;
+    int16_t tapY  = 0;
+    int16_t dragX = 0;
+    int16_t dragY = 0;
+    int16_t tilt  = 0;
+
+    bool operator==(const VersusInput& other) const = default;
+};
+
+/**
+@brief  Two bunnies dodging the same bombs, stepped at a fixed rate from nothing but both inputs.
+
+Each player has a GameRound of their own, both from the same seed, and a tap by
+either player is applied to both. So the rounds always hold the same bombs,
+and the only difference is where each player stands. That costs a second copy
+of the bomb motion, but GameRound stays the single set of rules. The first
+player hit loses; hits in the same step are a draw.
+
+step() depends only on the state and the inputs, so two peers that apply the
+same inputs stay identical, and save() / restore() let a rollback session
+rewind and replay frames.
+*/
+class VersusRound
+{
+public:
+    static constexpr int PLAYERS = 2;
+    static constexpr float STEP  = 1.0f / 60;
+
+    struct State
+    {
+        std::array<RoundState, PLAYERS> rounds;
+        uint32_t frame    = 0;
+        uint32_t endFrame = 0;
+    };
+
+    /** Rules, field and sprite sizes in points, and the seed both peers agreed on. */
+    void setup(const GameRules& rules, const ax::Size& field, const ax::Size& playerSize, const ax::Size& bombSize,
+               uint64_t seed);
+
+    /** Start a new match: both players centered, the first wave out. */
+    void reset();
+
+    /** Apply both players' inputs for the next frame and step it. Once the match is over only the frame counts. */
+    void step(const std::array<VersusInput, PLAYERS>& inputs);
+
+    uint32_t getFrame() const { return _frame; }
+    bool isOver() const { return _rounds[0].isOver() || _rounds[1].isOver(); }
+
+    /** The frame after the one that ended the match, or 0 while playing. */
+    uint32_t getEndFrame() const { return _endFrame; }
+
+    /** The player still standing, or -1 while playing and after a draw. */
+    int getWinner() const;
+
+    const GameRound& getRound(int player) const { return _rounds[player]; }
+
+    /** What the bot would do as `player`, as that player's input. */
+    VersusInput suggestBotInput(int player) const;
+
+    void save(State& state) const;
+    void restore(const State& state);
+
+    /** FNV-1a over everything step() reads, so peers can compare their states cheaply. */
+    uint64_t checksum() const;
+
+private:
+    std::array<GameRound, PLAYERS> _rounds;
+    uint64_t _seed     = 0;
+    float _fieldWidth  = 0.0f;
+    uint32_t _frame    = 0;
+    uint32_t _endFrame = 0;
+};
+
+/** The autoplay bot as a versus player: it acts every few frames, and then only with probability `skill`. */
+class VersusBot
+{
+public:
+    VersusBot(int player, float skill, uint64_t seed) : _player(player), _skill(skill), _rng(seed) {}
+
+    /** This frame's input, from the bot's own view of the round. */
+    VersusInput next(const VersusRound& round);
+
+private:
+    int _player;
+    float _skill;
+    Rng _rng;
+    uint32_t _frames = 0;
+};
@@ -0,0 +1,271 @@
+#include "VersusScene.h"
+
+#include <algorithm>
+#include <cmath>
+
+ax::Scene* VersusScene::createScene()
+{
+    auto scene = ax::Scene::create();
+    scene->setName("VersusScene");  // FrameTelemetry keys its histograms by scene name
+    auto layer = ax::utils::createInstance<VersusScene>();
+    scene->addChild(layer);
+
+    return scene;
+}
+
+// A slow frame is caught up with a few steps at most; beyond that the match slows down instead of stuttering
+static constexpr int MAX_STEPS_PER_FRAME = 4;
+
+static constexpr float RESULT_SECONDS = 3.0f;
+
+static const ax::Color3B BOT_TINT(255, 150, 150);
+
+static int16_t toInput(float value)
+{
+    return static_cast<int16_t>(std::clamp(std::lround(value), -32768l, 32767l));
+}
+
+bool VersusScene::init()
+{
+    if (!Node::init())
+    {
+        return false;
+    }
+
+    _director    = ax::Director::getInstance();
+    _config      = GameConfig::getInstance();
+    _visibleSize = _director->getVisibleSize();
+
+    auto bg = ax::Sprite::create("background.png");
+    bg->setAnchorPoint(ax::Vec2());
+    bg->setPosition(0, 0);
+    this->addChild(bg, -1);
+
+    for (int player = 0; player < VersusRound::PLAYERS; ++player)
+    {
+        _sprPlayers[player] = ax::Sprite::create("player.png");
+        this->addChild(_sprPlayers[player], 0);
+    }
+    _sprPlayers[1]->setColor(BOT_TINT);
+
+    _bombRenderer = SpriteBatchRenderer::create("bomb.png");
+    this->addChild(_bombRenderer, 1);
+
+    _lblStatus = ax::Label::createWithTTF("", "fonts/Marker Felt.ttf", 96);
+    _lblStatus->enableOutline(ax::Color32(255, 0, 0, 100), 6);
+    _lblStatus->setPosition(_visibleSize.width / 2, _visibleSize.height / 2);
+    _lblStatus->setVisible(false);
+    this->addChild(_lblStatus, 2);
+
+    if (!VersusTransport::createPair(*_config, _transports[0], _transports[1]))
+    {
+        return false;
+    }
+
+    // Both peers have to agree on the seed; in one process that is simply the same number
+    uint64_t seed = _config->seed;
+    if (seed == 0)
+    {
+        seed = InputQueue::now();
+    }
+
+    const auto settings = RollbackSession::Settings::fromConfig(*_config);
+    for (int player = 0; player < VersusRound::PLAYERS; ++player)
+    {
+        _rounds[player].setup(GameRules::fromConfig(*_config), _visibleSize, _sprPlayers[player]->getContentSize(),
+                              _bombRenderer->getInstanceSize(), seed);
+        _sessions[player] =
+            std::make_unique<RollbackSession>(_rounds[player], *_transports[player], player, settings);
+    }
+    _bot = std::make_unique<VersusBot>(1, _config->simBotSkill, ~seed);
+    _bombRenderer->reserve(64);
+
+    initTouch();
+    initAccelerometer();
+    initBackButtonListener();
+
+    resetMatch();
+    scheduleUpdate();
+
+    return true;
+}
+
+// Both peers start the next match together, as two players agreeing to a rematch would
+void VersusScene::resetMatch()
+{
+    for (int player = 0; player < VersusRound::PLAYERS; ++player)
+    {
+        _rounds[player].reset();
+        _sessions[player]->reset();
+    }
+    _localInput  = VersusInput{};
+    _accumulator = 0.0f;
+    _matchOver   = false;
+    _lblStatus->setVisible(false);
+    syncRound();
+}
+
+// Peer 0 is the player's view, predictions included; a rollback corrects it within a frame or two
+void VersusScene::syncRound()
+{
+    const VersusRound& round = _rounds[0];
+    for (int player = 0; player < VersusRound::PLAYERS; ++player)
+    {
+        _sprPlayers[player]->setPosition(round.getRound(player).getPlayerPosition());
+    }
+
+    // Both rounds hold the same bombs; the player's are drawn
+    const GameRound& bombs = round.getRound(0);
+    size_t i               = 0;
+    _bombRenderer->resize(bombs.getBombCount());
+    bombs.forEachBomb([this, &i](const ax::Vec2& position, float) { _bombRenderer->at(i++).position = position; });
+}
+
+Timeline::Task VersusScene::showResult(Timeline& timeline)
+{
+    int winner = _rounds[0].getWinner();
+    _lblStatus->setString(winner < 0 ? "Draw" : (winner == 0 ? "You win" : "You lose"));
+    _lblStatus->setVisible(true);
+
+    co_await timeline.seconds(RESULT_SECONDS);
+    resetMatch();
+}
+
+void VersusScene::initTouch()
+{
+    _touchListener               = ax::EventListenerTouchOneByOne::create();
+    _touchListener->onTouchBegan = [this](ax::Touch* touch, ax::Event* event) {
+        ax::Vec2 location = touch->getLocation();
+        _inputQueue.push(InputEvent::Type::TouchBegan, location.x, location.y);
+        return true;
+    };
+    _touchListener->onTouchMoved = [this](ax::Touch* touch, ax::Event* event) {
+        ax::Vec2 location = touch->getLocation();
+        _inputQueue.push(InputEvent::Type::TouchMoved, location.x, location.y);
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(_touchListener, this);
+}
+
+void VersusScene::initAccelerometer()
+{
+    ax::Device::setAccelerometerEnabled(true);
+    _accelerationListener =
+        ax::EventListenerAcceleration::create([this](ax::Acceleration* acceleration, ax::Event* event) {
+        _inputQueue.push(InputEvent::Type::Acceleration, static_cast<float>(acceleration->x),
+                         static_cast<float>(acceleration->y));
+    });
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(_accelerationListener, this);
+}
+
+void VersusScene::initBackButtonListener()
+{
+    _keyboardListener                = ax::EventListenerKeyboard::create();
+    _keyboardListener->onKeyReleased = [this](ax::EventKeyboard::KeyCode keyCode, ax::Event* event) {
+        _inputQueue.push(InputEvent::Type::KeyReleased, 0.0f, 0.0f, static_cast<int32_t>(keyCode));
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(_keyboardListener, this);
+}
+
+// Events fold into the next frame's input: the first tap, the last drag and the sum of the tilts
+void VersusScene::handleInput(const InputEvent& event)
+{
+    switch (event.type)
+    {
+    case InputEvent::Type::TouchBegan:
+        if (!(_localInput.flags & VersusInput::TAP))
+        {
+            _localInput.flags |= VersusInput::TAP;
+            _localInput.tapX = toInput(event.x);
+            _localInput.tapY = toInput(event.y);
+        }
+        break;
+    case InputEvent::Type::TouchMoved:
+        _localInput.flags |= VersusInput::DRAG;
+        _localInput.dragX = toInput(event.x);
+        _localInput.dragY = toInput(event.y);
+        break;
+    case InputEvent::Type::Acceleration:
+        _localInput.tilt = toInput(_localInput.tilt + event.x * 1000.0f);
+        break;
+    case InputEvent::Type::KeyReleased:
+        if (static_cast<ax::EventKeyboard::KeyCode>(event.code) == ax::EventKeyboard::KeyCode::KEY_BACK)
+        {
+            _director->end();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void VersusScene::update(float delta)
+{
+    _inputQueue.drain([this](const InputEvent& event) { handleInput(event); });
+    _timeline.advance(delta);
+    if (_matchOver)
+    {
+        return;
+    }
+
+    _accumulator = std::min(_accumulator + delta, VersusRound::STEP * MAX_STEPS_PER_FRAME);
+    while (_accumulator >= VersusRound::STEP)
+    {
+        _accumulator -= VersusRound::STEP;
+
+        uint64_t nowUs = InputQueue::now() / 1000;
+        _sessions[0]->advance(_localInput, nowUs);
+        _sessions[1]->advance(_bot->next(_rounds[1]), nowUs);
+        _localInput = VersusInput{};
+    }
+    syncRound();
+
+    if (_sessions[0]->isDecided() && _sessions[1]->isDecided())
+    {
+        _matchOver = true;
+        _timeline.start(showResult(_timeline));
+    }
+}
+
+// One report per scene, covering every match played in it
+void VersusScene::writeReport()
+{
+    std::string report;
+    for (const auto& session : _sessions)
+    {
+        if (session)
+        {
+            report += session->buildReport() + "\n";
+        }
+    }
+
+    auto fileUtils   = ax::FileUtils::getInstance();
+    std::string path = _config->versusReport.empty() ? fileUtils->getWritablePath() + "versus_report.txt"
+                                                     : _config->versusReport;
+    if (!fileUtils->writeStringToFile(report, path))
+    {
+        AXLOGW("Failed to write the versus report to {}", path);
+    }
+}
+
+VersusScene::VersusScene()
+    : _director(nullptr)
+    , _config(nullptr)
+    , _touchListener(nullptr)
+    , _keyboardListener(nullptr)
+    , _accelerationListener(nullptr)
+    , _sprPlayers{}
+    , _bombRenderer(nullptr)
+    , _lblStatus(nullptr)
+    , _accumulator(0.0f)
+    , _matchOver(false)
+{
+}
+
+VersusScene::~VersusScene()
+{
+    AXLOGD("Freeing VersusScene resources.");
+    if (_config)
+    {
+        writeReport();
+    }
+}
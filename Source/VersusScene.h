@@ -0,0 +1,63 @@
+#pragma once
+
+#include "axmol/axmol.h"
+#include "GameConfig.h"
+#include "InputQueue.h"
+#include "RollbackSession.h"
+#include "SpriteBatchRenderer.h"
+#include "Timeline.h"
+#include "VersusRound.h"
+#include "VersusTransport.h"
+
+#include <memory>
+
+/**
+@brief  A versus match against the bot, played through two rollback peers in this process.
+
+The player is peer 0 and the bot peer 1. Each peer has its own VersusRound and
+RollbackSession and they only talk through the `versus-transport`, with the
+simulated latency, jitter and loss, so what is on screen is exactly what a
+networked player would see. Peer 0's round is drawn.
+*/
+class VersusScene : public ax::Node
+{
+public:
+    static ax::Scene* createScene();
+    bool init() override;
+    void update(float delta) override;
+
+    VersusScene();
+    ~VersusScene() override;
+
+private:
+    void initTouch();
+    void initAccelerometer();
+    void initBackButtonListener();
+    void handleInput(const InputEvent& event);
+    void resetMatch();
+    void syncRound();
+    Timeline::Task showResult(Timeline& timeline);
+    void writeReport();
+
+    ax::Director* _director;
+    GameConfig* _config;
+    ax::Size _visibleSize;
+    InputQueue _inputQueue;
+    ax::EventListenerTouchOneByOne* _touchListener;
+    ax::EventListenerKeyboard* _keyboardListener;
+    ax::EventListenerAcceleration* _accelerationListener;
+
+    ax::Sprite* _sprPlayers[VersusRound::PLAYERS];
+    SpriteBatchRenderer* _bombRenderer;
+    ax::Label* _lblStatus;
+
+    std::unique_ptr<VersusTransport> _transports[VersusRound::PLAYERS];
+    VersusRound _rounds[VersusRound::PLAYERS];
+    std::unique_ptr<RollbackSession> _sessions[VersusRound::PLAYERS];
+    std::unique_ptr<VersusBot> _bot;
+
+    VersusInput _localInput;  // everything the player did since the last frame went out
+    float _accumulator;       // display time not yet stepped
+    bool _matchOver;
+    Timeline _timeline;
+};
@@ -0,0 +1,159 @@
+#include "VersusTransport.h"
+#include "axmol/axmol.h"
+
+#include <cstring>
+
+namespace
+{
+// Room for a few frames' packets at the worst latency, so steady play does not grow the list
+constexpr size_t HELD_RESERVE = 64;
+}  // namespace
+
+bool VersusTransport::createPair(const GameConfig& config, std::unique_ptr<VersusTransport>& first,
+                                 std::unique_ptr<VersusTransport>& second)
+{
+    if (config.versusTransport == "udp")
+    {
+        auto port = static_cast<uint16_t>(config.versusPort);
+        auto a    = std::make_unique<UdpTransport>();
+        auto b    = std::make_unique<UdpTransport>();
+        if (!a->open(port, "127.0.0.1", port + 1) || !b->open(port + 1, "127.0.0.1", port))
+        {
+            AXLOGE("Versus: cannot bind UDP ports {} and {}", port, port + 1);
+            return false;
+        }
+        first  = std::move(a);
+        second = std::move(b);
+    }
+    else
+    {
+        auto a = std::make_unique<LoopbackTransport>();
+        auto b = std::make_unique<LoopbackTransport>();
+        LoopbackTransport::connect(*a, *b);
+        first  = std::move(a);
+        second = std::move(b);
+    }
+
+    // Each direction loses its own packets
+    Conditions conditions{config.versusLatencyMs, config.versusJitterMs, config.versusLoss};
+    first->setConditions(conditions, 1);
+    second->setConditions(conditions, 2);
+    return true;
+}
+
+void VersusTransport::setConditions(const Conditions& conditions, uint64_t seed)
+{
+    _conditions = conditions;
+    _rng.setState(seed);
+    _held.reserve(HELD_RESERVE);
+}
+
+void VersusTransport::send(const uint8_t* data, size_t size, uint64_t nowUs)
+{
+    if (size > MAX_PACKET)
+    {
+        return;
+    }
+    ++_sent;
+
+    if (_conditions.loss > 0.0f && _rng.next01() < _conditions.loss)
+    {
+        ++_lost;
+        return;
+    }
+
+    float delayMs = _conditions.latencyMs + _conditions.jitterMs * _rng.next01();
+    if (delayMs <= 0.0f)
+    {
+        transmit(data, size);
+        return;
+    }
+
+    Held held;
+    held.dueUs = nowUs + static_cast<uint64_t>(delayMs * 1000.0f);
+    held.size  = static_cast<uint16_t>(size);
+    memcpy(held.data.data(), data, size);
+    _held.push_back(held);
+}
+
+void VersusTransport::flush(uint64_t nowUs)
+{
+    for (size_t i = 0; i < _held.size();)
+    {
+        if (_held[i].dueUs <= nowUs)
+        {
+            transmit(_held[i].data.data(), _held[i].size);
+            _held[i] = _held.back();
+            _held.pop_back();
+            continue;
+        }
+        ++i;
+    }
+}
+
+void LoopbackTransport::connect(LoopbackTransport& a, LoopbackTransport& b)
+{
+    a._peer = &b;
+    b._peer = &a;
+}
+
+void LoopbackTransport::transmit(const uint8_t* data, size_t size)
+{
+    if (!_peer)
+    {
+        return;
+    }
+    Packet packet;
+    packet.size = static_cast<uint16_t>(size);
+    memcpy(packet.data.data(), data, size);
+    _peer->_inbox.push(packet);
+}
+
+bool LoopbackTransport::receive(uint8_t* data, size_t& size)
+{
+    Packet packet;
+    if (!_inbox.pop(packet))
+    {
+        return false;
+    }
+    size = packet.size;
+    memcpy(data, packet.data.data(), size);
+    return true;
+}
+
+bool UdpTransport::open(uint16_t localPort, const std::string& peerHost, uint16_t peerPort)
+{
+    if (!_socket.open(AF_INET, SOCK_DGRAM))
+    {
+        return false;
+    }
+    if (_socket.bind("0.0.0.0", localPort) != 0)
+    {
+        _socket.close();
+        return false;
+    }
+    _socket.set_nonblocking(true);
+    _peer = yasio::ip::endpoint(peerHost.c_str(), peerPort);
+    return true;
+}
+
+void UdpTransport::transmit(const uint8_t* data, size_t size)
+{
+    _socket.sendto(data, static_cast<int>(size), _peer);
+}
+
+bool UdpTransport::receive(uint8_t* data, size_t& size)
+{
+    if (!_socket.is_open())
+    {
+        return false;
+    }
+    yasio::ip::endpoint from;
+    int received = _socket.recvfrom(data, static_cast<int>(MAX_PACKET), from);
+    if (received <= 0)
+    {
+        return false;
+    }
+    size = static_cast<size_t>(received);
+    return true;
+}
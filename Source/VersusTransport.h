@@ -0,0 +1,124 @@
+#pragma once
+
+#include "GameConfig.h"
+#include "Rng.h"
+#include "SpscRing.h"
+#include "yasio/xxsocket.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+@brief  Carries versus packets between two peers, with simulated latency, jitter and loss.
+
+send() does not transmit right away: each packet is held for the latency plus
+a random share of the jitter, or dropped with the loss probability, and poll()
+lets out whatever is due before reading what arrived. Jitter can reorder
+packets, like a real network. Time is passed in, so a headless run can play
+faster than real time with the same conditions.
+
+LoopbackTransport connects two peers in one process; UdpTransport goes through
+real sockets, e.g. two ports on 127.0.0.1.
+*/
+class VersusTransport
+{
+public:
+    static constexpr size_t MAX_PACKET = 512;
+
+    struct Conditions
+    {
+        float latencyMs = 0.0f;  // one way
+        float jitterMs  = 0.0f;  // extra delay, uniform in [0, jitterMs)
+        float loss      = 0.0f;  // chance a packet is dropped, in [0, 1]
+    };
+
+    virtual ~VersusTransport() = default;
+
+    /**
+    @brief  Both ends of a link inside this process, of the `versus-transport` kind and with the simulated conditions.
+    @return false if the UDP ports cannot be bound.
+    */
+    static bool createPair(const GameConfig& config, std::unique_ptr<VersusTransport>& first,
+                           std::unique_ptr<VersusTransport>& second);
+
+    void setConditions(const Conditions& conditions, uint64_t seed);
+
+    /** Queue `size` bytes (at most MAX_PACKET) for the peer. */
+    void send(const uint8_t* data, size_t size, uint64_t nowUs);
+
+    /** Transmit the packets that are due, then hand every received one to `fn(data, size)`. */
+    template <typename Fn>
+    void poll(uint64_t nowUs, Fn&& fn)
+    {
+        flush(nowUs);
+        std::array<uint8_t, MAX_PACKET> buffer;
+        size_t size = 0;
+        while (receive(buffer.data(), size))
+        {
+            fn(buffer.data(), size);
+        }
+    }
+
+    uint32_t getSentCount() const { return _sent; }
+    uint32_t getLostCount() const { return _lost; }
+
+protected:
+    virtual void transmit(const uint8_t* data, size_t size) = 0;
+    virtual bool receive(uint8_t* data, size_t& size) = 0;
+
+private:
+    struct Held
+    {
+        uint64_t dueUs;
+        uint16_t size;
+        std::array<uint8_t, MAX_PACKET> data;
+    };
+
+    void flush(uint64_t nowUs);
+
+    Conditions _conditions;
+    Rng _rng;
+    std::vector<Held> _held;
+    uint32_t _sent = 0;
+    uint32_t _lost = 0;
+};
+
+/** Two peers in one process; packets are copied straight into the other side's inbox. Single thread. */
+class LoopbackTransport : public VersusTransport
+{
+public:
+    static void connect(LoopbackTransport& a, LoopbackTransport& b);
+
+protected:
+    void transmit(const uint8_t* data, size_t size) override;
+    bool receive(uint8_t* data, size_t& size) override;
+
+private:
+    struct Packet
+    {
+        uint16_t size;
+        std::array<uint8_t, MAX_PACKET> data;
+    };
+
+    LoopbackTransport* _peer = nullptr;
+    SpscRing<Packet, 64> _inbox;  // full means lost, as on a congested link
+};
+
+/** Non-blocking UDP between two endpoints. */
+class UdpTransport : public VersusTransport
+{
+public:
+    /** Bind `localPort` on all interfaces and send to `peerHost:peerPort`. @return false if the port is taken. */
+    bool open(uint16_t localPort, const std::string& peerHost, uint16_t peerPort);
+
+protected:
+    void transmit(const uint8_t* data, size_t size) override;
+    bool receive(uint8_t* data, size_t& size) override;
+
+private:
+    yasio::xxsocket _socket;
+    yasio::ip::endpoint _peer;
+};
@@ -0,0 +1,27 @@
+#version 310 es
+
+// SpriteBatchRenderer with motion enabled: each corner carries its instance's velocity and the
+// time it was at its position, and the quad is moved by the velocity from then to u_motionTime.
+// Plain per-vertex attributes and one float uniform, so it runs on any GL, software ones included.
+
+layout(location = POSITION) in vec4 a_position;
+layout(location = COLOR0) in vec4 a_color;
+layout(location = TEXCOORD0) in vec2 a_texCoord;
+layout(location = TEXCOORD1) in vec3 a_motion;  // xy velocity, z time
+
+layout(location = COLOR0) out vec4 v_color;
+layout(location = TEXCOORD0) out vec2 v_texCoord;
+
+layout(std140) uniform vs_ub {
+    mat4 u_MVPMatrix;
+    float u_motionTime;
+};
+
+void main()
+{
+    vec4 position = a_position;
+    position.xy += a_motion.xy * (u_motionTime - a_motion.z);
+    gl_Position = u_MVPMatrix * position;
+    v_color     = a_color;
+    v_texCoord  = a_texCoord;
+}
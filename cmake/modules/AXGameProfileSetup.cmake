@@ -0,0 +1,61 @@
+# Profile-guided optimization and link-time optimization for the game and the engine.
+#
+# HAPPY_PGO=GENERATE builds an instrumented binary that writes profiles to HAPPY_PGO_DIR
+# when it exits; HAPPY_PGO=USE rebuilds with them. tools/pgo_build.sh drives the whole
+# cycle headless on Linux. The flags are added globally (before AXGameEngineSetup) so the
+# engine's hot paths - scene graph visit, renderer, scheduler - are trained too.
+#
+# GCC keys its .gcda files by object path, so GENERATE and USE must share a build folder.
+
+set(HAPPY_PGO OFF CACHE STRING "Profile-guided optimization phase: OFF, GENERATE or USE")
+set_property(CACHE HAPPY_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(HAPPY_PGO_DIR "${CMAKE_BINARY_DIR}/pgo-profile" CACHE PATH "Where training runs write profiles and USE reads them")
+option(HAPPY_LTO "Link-time optimization, on by default for PGO builds" OFF)
+
+if(NOT HAPPY_PGO STREQUAL "OFF")
+  if(NOT CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+    message(FATAL_ERROR "HAPPY_PGO needs GCC or Clang, found ${CMAKE_CXX_COMPILER_ID}")
+  endif()
+  if(NOT CMAKE_BUILD_TYPE STREQUAL "Release" AND NOT CMAKE_BUILD_TYPE STREQUAL "RelWithDebInfo")
+    message(WARNING "HAPPY_PGO is meant for optimized builds, CMAKE_BUILD_TYPE is '${CMAKE_BUILD_TYPE}'")
+  endif()
+endif()
+
+# PGO implies LTO for this configure only, so going back to HAPPY_PGO=OFF also turns LTO back off
+if(HAPPY_LTO OR NOT HAPPY_PGO STREQUAL "OFF")
+  include(CheckIPOSupported)
+  check_ipo_supported(RESULT _happy_ipo_supported OUTPUT _happy_ipo_error LANGUAGES C CXX)
+  if(_happy_ipo_supported)
+    set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+  else()
+    message(WARNING "Link-time optimization is not supported here: ${_happy_ipo_error}")
+  endif()
+endif()
+
+if(HAPPY_PGO STREQUAL "GENERATE")
+  file(MAKE_DIRECTORY ${HAPPY_PGO_DIR})
+  add_compile_options(-fprofile-generate=${HAPPY_PGO_DIR})
+  add_link_options(-fprofile-generate=${HAPPY_PGO_DIR})
+  if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    # The audio and loader threads bump counters too
+    add_compile_options(-fprofile-update=prefer-atomic)
+  endif()
+  message(STATUS "PGO: instrumented build, profiles go to ${HAPPY_PGO_DIR}")
+elseif(HAPPY_PGO STREQUAL "USE")
+  if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    # partial-training keeps code the sessions never reached optimized for speed instead of size
+    add_compile_options(-fprofile-use=${HAPPY_PGO_DIR} -fprofile-partial-training -fprofile-correction
+                        -Wno-missing-profile)
+  else()
+    set(_happy_profdata ${HAPPY_PGO_DIR}/default.profdata)
+    if(NOT EXISTS ${_happy_profdata})
+      message(FATAL_ERROR "PGO: ${_happy_profdata} not found, merge the training runs with llvm-profdata first")
+    endif()
+    add_compile_options(-fprofile-use=${_happy_profdata} -Wno-profile-instr-unprofiled
+                        -Wno-profile-instr-out-of-date)
+    add_link_options(-fprofile-use=${_happy_profdata})
+  endif()
+  message(STATUS "PGO: optimizing with profiles from ${HAPPY_PGO_DIR}")
+elseif(NOT HAPPY_PGO STREQUAL "OFF")
+  message(FATAL_ERROR "HAPPY_PGO must be OFF, GENERATE or USE, got '${HAPPY_PGO}'")
+endif()
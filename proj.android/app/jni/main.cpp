@@ -29,6 +29,8 @@
 #include <jni.h>
 
 #include "AppDelegate.h"
+#include "ImageTier.h"
+#include "MemoryBudget.h"
 
 #define LOG_TAG   "main"
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
@@ -43,3 +45,14 @@ void axmol_android_app_init(JNIEnv* env)
     LOGD("axmol_android_app_init");
     appDelegate.reset(new AppDelegate());
 }
+
+extern "C" JNIEXPORT void JNICALL Java_dev_axmol_app_AppActivity_nativeOnLowMemory(JNIEnv*, jclass)
+{
+    MemoryBudget::getInstance()->onLowMemory();
+    ImageTier::getInstance()->onLowMemory();
+}
+
+extern "C" JNIEXPORT void JNICALL Java_dev_axmol_app_AppActivity_nativeOnThermalStatus(JNIEnv*, jclass, jboolean hot)
+{
+    ImageTier::getInstance()->setThermalPressure(hot);
+}
@@ -25,10 +25,12 @@ THE SOFTWARE.
 ****************************************************************************/
 package dev.axmol.app;
 
+import android.content.ComponentCallbacks2;
 import android.os.Bundle;
 import dev.axmol.lib.AxmolActivity;
 import dev.axmol.lib.SharedLoader;
 import android.os.Build;
+import android.os.PowerManager;
 import android.view.WindowManager;
 import android.view.WindowManager.LayoutParams;
 
@@ -58,7 +60,24 @@ public class AppActivity extends AxmolActivity {
             getWindow().setAttributes(lp);
         }
         // DO OTHER INITIALIZATION BELOW
-        
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q) {
+            PowerManager powerManager = getSystemService(PowerManager.class);
+            powerManager.addThermalStatusListener(status -> {
+                final boolean hot = status >= PowerManager.THERMAL_STATUS_SEVERE;
+                runOnGLThread(() -> nativeOnThermalStatus(hot));
+            });
+        }
+    }
+
+    @Override
+    public void onTrimMemory(int level) {
+        super.onTrimMemory(level);
+        // Backgrounded levels are already handled by the purge in applicationDidEnterBackground
+        if (level == ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW || level == ComponentCallbacks2.TRIM_MEMORY_RUNNING_CRITICAL) {
+            runOnGLThread(() -> nativeOnLowMemory());
+        }
     }
 
+    private static native void nativeOnLowMemory();
+    private static native void nativeOnThermalStatus(boolean hot);
 }
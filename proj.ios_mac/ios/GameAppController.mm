@@ -28,6 +28,9 @@
 #import "GameAppController.h"
 #import "GameViewController.h"
 
+#include "ImageTier.h"
+#include "MemoryBudget.h"
+
 @implementation GameAppController
 
 #pragma mark -
@@ -39,4 +42,29 @@
     return viewController;
 }
 
+- (void)applicationDidReceiveMemoryWarning:(UIApplication*)application
+{
+    [super applicationDidReceiveMemoryWarning:application];
+    MemoryBudget::getInstance()->onLowMemory();
+    ImageTier::getInstance()->onLowMemory();
+}
+
+- (BOOL)application:(UIApplication*)application didFinishLaunchingWithOptions:(NSDictionary*)launchOptions
+{
+    BOOL launched = [super application:application didFinishLaunchingWithOptions:launchOptions];
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(thermalStateDidChange:)
+                                                 name:NSProcessInfoThermalStateDidChangeNotification
+                                               object:nil];
+    return launched;
+}
+
+// Posted on an arbitrary thread
+- (void)thermalStateDidChange:(NSNotification*)notification
+{
+    bool hot = [NSProcessInfo processInfo].thermalState >= NSProcessInfoThermalStateSerious;
+    ax::Director::getInstance()->getScheduler()->runOnAxmolThread(
+        [hot] { ImageTier::getInstance()->setThermalPressure(hot); });
+}
+
 @end
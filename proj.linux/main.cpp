@@ -24,6 +24,10 @@
  ****************************************************************************/
 
 #include "AppDelegate.h"
+#include "AllocTracker.h"
+#include "BatchSim.h"
+#include "GameConfig.h"
+#include "VersusBench.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -41,8 +45,36 @@ int axmol_main()
 
 int main(int argc, char** argv)
 {
+    GameConfig::getInstance()->parseCommandLine(argc, argv);
+
+    // Headless: no window, no Director, just GameRound on every core
+    if (GameConfig::getInstance()->simRounds > 0)
+    {
+        return BatchSim(*GameConfig::getInstance()).run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (GameConfig::getInstance()->versusFrames > 0)
+    {
+        return VersusBench(*GameConfig::getInstance()).run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+#if !HAPPY_ALLOC_TRACKING
+    // Without the tracker the gate would play an invulnerable round until quit and report a pass it never checked
+    if (GameConfig::getInstance()->zeroAllocGateFrames > 0)
+    {
+        fprintf(stderr, "--zero-alloc-gate needs a build configured with -DHAPPY_ALLOC_TRACKING=ON\n");
+        return EXIT_FAILURE;
+    }
+#endif
+
     auto result = axmol_main();
 
+#if HAPPY_ALLOC_TRACKING
+    if (AllocTracker::hasGateFailed())
+    {
+        result = EXIT_FAILURE;
+    }
+#endif
+
 #if AX_OBJECT_LEAK_DETECTION
     Object::printLeaks();
 #endif
@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""Compile particle designer plists into the binary pack read by ParticlePack.
+
+Every emitter becomes a fixed-size record (see ParticleDescriptor in
+Source/ParticlePack.h). Embedded textures are decoded to premultiplied RGBA8
+and de-duplicated, so the game can upload them straight from the mapped file
+without any XML, base64, gzip or image decoding at runtime. Emitters without
+embedded data keep a reference to their texture file instead.
+
+Usage: compile_particles.py -o particles.pak explosion.plist fire.plist ...
+"""
+
+import argparse
+import base64
+import gzip
+import hashlib
+import os
+import plistlib
+import struct
+import sys
+import zlib
+
+MAGIC = b"HPAK"
+VERSION = 1
+NO_TEXTURE = 0xFFFFFFFF
+ALIGNMENT = 16
+
+HEADER = struct.Struct("<4s3I")
+TEXTURE = struct.Struct("<4I")
+# Must match ParticleDescriptor in Source/ParticlePack.h
+DESCRIPTOR = struct.Struct("<32s64s6I45f")
+
+
+def fail(message):
+    sys.exit("compile_particles: " + message)
+
+
+def inflate(data):
+    if data[:2] == b"\x1f\x8b":
+        return gzip.decompress(data)
+    try:
+        return zlib.decompress(data)
+    except zlib.error:
+        return data
+
+
+def decode_tiff(data, source):
+    """Decode an uncompressed 8-bit RGB(A) TIFF, the format particle designers embed."""
+    endian = {b"II": "<", b"MM": ">"}.get(data[:2])
+    if endian is None or struct.unpack(endian + "H", data[2:4])[0] != 42:
+        fail("%s: embedded texture is not a TIFF image" % source)
+
+    sizes = {1: 1, 3: 2, 4: 4}
+    tags = {}
+    ifd = struct.unpack(endian + "I", data[4:8])[0]
+    (count,) = struct.unpack(endian + "H", data[ifd : ifd + 2])
+    for i in range(count):
+        entry = ifd + 2 + 12 * i
+        tag, kind, n = struct.unpack(endian + "HHI", data[entry : entry + 8])
+        if kind not in sizes:
+            continue
+        width = sizes[kind] * n
+        where = entry + 8 if width <= 4 else struct.unpack(endian + "I", data[entry + 8 : entry + 12])[0]
+        fmt = endian + {1: "B", 3: "H", 4: "I"}[kind] * n
+        tags[tag] = struct.unpack(fmt, data[where : where + width])
+
+    width, height = tags[256][0], tags[257][0]
+    samples = tags.get(277, (1,))[0]
+    if tags.get(259, (1,))[0] != 1 or tags.get(284, (1,))[0] != 1 or samples not in (3, 4):
+        fail("%s: only uncompressed, interleaved RGB(A) TIFF textures are supported" % source)
+    if any(bits != 8 for bits in tags.get(258, (8,))):
+        fail("%s: only 8-bit TIFF textures are supported" % source)
+
+    pixels = b"".join(data[o : o + n] for o, n in zip(tags[273], tags[279]))
+    pixels = pixels[: width * height * samples]
+    associated = tags.get(338, (0,))[0] == 1
+
+    rgba = bytearray(width * height * 4)
+    for i in range(width * height):
+        px = pixels[i * samples : (i + 1) * samples]
+        a = px[3] if samples == 4 else 255
+        if associated or a == 255:
+            rgba[i * 4 : i * 4 + 3] = px[:3]
+        else:
+            rgba[i * 4 : i * 4 + 3] = bytes((c * a + 127) // 255 for c in px[:3])
+        rgba[i * 4 + 3] = a
+    return width, height, bytes(rgba)
+
+
+def descriptor(name, texture, texture_file, d):
+    def f(key, default=0.0):
+        return float(d.get(key, default))
+
+    def color(prefix):
+        return [f(prefix + c) for c in ("Red", "Green", "Blue", "Alpha")]
+
+    floats = [
+        f("duration"),
+        f("angle"), f("angleVariance"),
+        f("speed"), f("speedVariance"),
+        f("gravityx"), f("gravityy"),
+        f("radialAcceleration"), f("radialAccelVariance"),
+        f("tangentialAcceleration"), f("tangentialAccelVariance"),
+        f("sourcePositionVariancex"), f("sourcePositionVariancey"),
+        f("particleLifespan"), f("particleLifespanVariance"),
+        f("startParticleSize"), f("startParticleSizeVariance"),
+        f("finishParticleSize"), f("finishParticleSizeVariance"),
+        f("rotationStart"), f("rotationStartVariance"),
+        f("rotationEnd"), f("rotationEndVariance"),
+    ]
+    floats += color("startColor") + color("startColorVariance")
+    floats += color("finishColor") + color("finishColorVariance")
+    floats += [
+        f("maxRadius"), f("maxRadiusVariance"),
+        f("minRadius"), f("minRadiusVariance"),
+        f("rotatePerSecond"), f("rotatePerSecondVariance"),
+    ]
+
+    encoded_name = name.encode("utf-8")
+    encoded_file = texture_file.encode("utf-8")
+    if len(encoded_name) >= 32 or len(encoded_file) >= 64:
+        fail("%s: emitter or texture file name too long" % name)
+
+    return DESCRIPTOR.pack(
+        encoded_name,
+        encoded_file,
+        texture,
+        int(f("emitterType")),
+        int(f("positionType")),
+        int(f("maxParticles")),
+        int(f("blendFuncSource", 770)),
+        int(f("blendFuncDestination", 771)),
+        *floats
+    )
+
+
+def align(offset):
+    return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("plists", nargs="+")
+    args = parser.parse_args()
+
+    records = []
+    textures = []
+    texture_index = {}
+
+    for path in sorted(args.plists):
+        name = os.path.splitext(os.path.basename(path))[0]
+        with open(path, "rb") as fp:
+            d = plistlib.load(fp)
+
+        texture = NO_TEXTURE
+        texture_file = ""
+        embedded = d.get("textureImageData", "")
+        if embedded:
+            image = decode_tiff(inflate(base64.b64decode(embedded)), path)
+            key = hashlib.sha1(image[2]).digest()
+            if key not in texture_index:
+                texture_index[key] = len(textures)
+                textures.append(image)
+            texture = texture_index[key]
+        else:
+            texture_file = d.get("textureFileName", "")
+        records.append(descriptor(name, texture, texture_file, d))
+
+    offset = align(HEADER.size + DESCRIPTOR.size * len(records) + TEXTURE.size * len(textures))
+    table = []
+    for width, height, pixels in textures:
+        table.append(TEXTURE.pack(width, height, offset, len(pixels)))
+        offset = align(offset + len(pixels))
+
+    with open(args.output, "wb") as out:
+        out.write(HEADER.pack(MAGIC, VERSION, len(records), len(textures)))
+        out.write(b"".join(records))
+        out.write(b"".join(table))
+        for width, height, pixels in textures:
+            out.write(b"\0" * (align(out.tell()) - out.tell()))
+            out.write(pixels)
+
+    print("compile_particles: %d emitters, %d textures -> %s" % (len(records), len(textures), args.output))
+
+
+if __name__ == "__main__":
+    main()
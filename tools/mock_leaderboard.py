@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Local stand-in for the leaderboard endpoint used by LeaderboardClient.
+
+POST /scores takes {"scores": [{"player", "score", "time"}, ...]} and keeps the
+best score per player; GET /scores returns the top ten. --fail-rate, --status
+and --latency-ms make it misbehave, to exercise the client's backoff and
+persisted queue.
+
+Usage: mock_leaderboard.py --port 8080 --fail-rate 0.3
+       HappyAxmol --leaderboard-url=http://127.0.0.1:8080/scores
+"""
+
+import argparse
+import json
+import random
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+best = {}
+lock = threading.Lock()
+
+
+def make_handler(args):
+    class Handler(BaseHTTPRequestHandler):
+        def reply(self, status, payload):
+            body = json.dumps(payload).encode()
+            self.send_response(status)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def do_GET(self):
+            if self.path != "/scores":
+                self.reply(404, {"error": "not found"})
+                return
+            with lock:
+                top = sorted(best.items(), key=lambda item: item[1], reverse=True)[:10]
+            self.reply(200, {"scores": [{"player": p, "score": s} for p, s in top]})
+
+        def do_POST(self):
+            if args.latency_ms > 0:
+                time.sleep(args.latency_ms / 1000.0)
+            if self.path != "/scores":
+                self.reply(404, {"error": "not found"})
+                return
+            if random.random() < args.fail_rate:
+                self.reply(args.status, {"error": "injected failure"})
+                return
+
+            try:
+                length = int(self.headers.get("Content-Length", 0))
+                scores = json.loads(self.rfile.read(length))["scores"]
+                entries = [(str(s["player"]), int(s["score"])) for s in scores]
+            except (ValueError, KeyError, TypeError):
+                self.reply(400, {"error": "malformed batch"})
+                return
+
+            with lock:
+                for player, score in entries:
+                    best[player] = max(score, best.get(player, score))
+            self.reply(200, {"accepted": len(entries)})
+
+        def log_message(self, format, *args):
+            sys.stderr.write("mock_leaderboard: %s\n" % (format % args))
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--fail-rate", type=float, default=0.0, help="fraction of POSTs answered with --status")
+    parser.add_argument("--status", type=int, default=503, help="status of injected failures")
+    parser.add_argument("--latency-ms", type=int, default=0, help="delay before answering a POST")
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer(("127.0.0.1", args.port), make_handler(args))
+    print("mock_leaderboard: listening on http://127.0.0.1:%d/scores" % args.port)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
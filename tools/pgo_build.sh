@@ -0,0 +1,87 @@
+#!/usr/bin/env bash
+# Profile-guided + link-time optimized Linux build, trained on unattended gameplay.
+#
+#   1. Release build (baseline)
+#   2. Instrumented build (-DHAPPY_PGO=GENERATE), run headless under Xvfb:
+#      an autoplay round (input, bombs, explosions, audio) and a stress ramp (scene graph, renderer)
+#   3. Same folder rebuilt with the profiles (-DHAPPY_PGO=USE)
+#   4. Baseline and PGO builds run the same fixed-load benchmark; the frame-time delta is printed
+#
+# Environment: BUILD_ROOT (default build-pgo), TRAIN_SECONDS (60), BENCH_BOMBS (1500),
+# BENCH_SECONDS (10), BENCH_RUNS (3). Needs xvfb-run unless DISPLAY is set.
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_ROOT="${BUILD_ROOT:-$ROOT/build-pgo}"
+TRAIN_SECONDS="${TRAIN_SECONDS:-60}"
+BENCH_BOMBS="${BENCH_BOMBS:-1500}"
+BENCH_SECONDS="${BENCH_SECONDS:-10}"
+BENCH_RUNS="${BENCH_RUNS:-3}"
+JOBS="$(nproc)"
+
+RELEASE_DIR="$BUILD_ROOT/release"
+PGO_DIR="$BUILD_ROOT/pgo"
+PROFILE_DIR="$BUILD_ROOT/profile"
+REPORT_DIR="$BUILD_ROOT/reports"
+
+headless() {
+    if [[ -n "${DISPLAY:-}" ]]; then
+        "$@"
+    else
+        xvfb-run -a -s "-screen 0 1280x1024x24" env LIBGL_ALWAYS_SOFTWARE=1 "$@"
+    fi
+}
+
+# The game resolves Content relative to its working directory
+run_game() {
+    local build="$1"
+    shift
+    (cd "$build/bin/HappyAxmol" && headless ./HappyAxmol "$@")
+}
+
+configure_and_build() {
+    local build="$1"
+    shift
+    cmake -S "$ROOT" -B "$build" -DCMAKE_BUILD_TYPE=Release "$@"
+    cmake --build "$build" --config Release -j"$JOBS"
+}
+
+# Median over BENCH_RUNS of the work p50 (update start to end of draw) at BENCH_BOMBS live bombs
+benchmark() {
+    local build="$1" name="$2"
+    for run in $(seq "$BENCH_RUNS"); do
+        local report="$REPORT_DIR/$name-$run.txt"
+        run_game "$build" --stress --stress-step="$BENCH_BOMBS" --stress-max-bombs="$BENCH_BOMBS" \
+            --stress-step-seconds="$BENCH_SECONDS" --stress-budget-ms=1000 --stress-report="$report" >/dev/null
+        awk '/^work_ms/ { print $3 }' "$report"
+    done | sort -n | awk '{ v[NR] = $1 } END { print v[int((NR + 1) / 2)] }'
+}
+
+mkdir -p "$REPORT_DIR"
+rm -rf "$PROFILE_DIR"
+
+echo "== Release baseline"
+configure_and_build "$RELEASE_DIR" -DHAPPY_PGO=OFF -DHAPPY_LTO=OFF
+
+echo "== Instrumented build"
+configure_and_build "$PGO_DIR" -DHAPPY_PGO=GENERATE -DHAPPY_PGO_DIR="$PROFILE_DIR"
+
+echo "== Training (${TRAIN_SECONDS}s autoplay + stress ramp)"
+run_game "$PGO_DIR" --autoplay --invulnerable --spawn-interval=2 --wave-size=6 --quit-after="$TRAIN_SECONDS"
+run_game "$PGO_DIR" --stress --stress-step=250 --stress-max-bombs=3000 --stress-step-seconds=1 \
+    --stress-report="$REPORT_DIR/training-stress.txt"
+
+# Clang leaves raw profiles that must be merged; GCC's .gcda files are read as they are
+if compgen -G "$PROFILE_DIR/*.profraw" >/dev/null; then
+    llvm-profdata merge -output="$PROFILE_DIR/default.profdata" "$PROFILE_DIR"/*.profraw
+fi
+
+echo "== Optimized build"
+configure_and_build "$PGO_DIR" -DHAPPY_PGO=USE -DHAPPY_PGO_DIR="$PROFILE_DIR"
+
+echo "== Benchmark: $BENCH_BOMBS bombs, ${BENCH_SECONDS}s, median of $BENCH_RUNS runs"
+release_ms="$(benchmark "$RELEASE_DIR" release)"
+pgo_ms="$(benchmark "$PGO_DIR" pgo)"
+awk -v r="$release_ms" -v p="$pgo_ms" 'BEGIN {
+    printf "frame work p50: release %.2f ms, pgo+lto %.2f ms, delta %+.2f ms (%+.1f%%)\n", r, p, p - r, (p - r) / r * 100
+}' | tee "$REPORT_DIR/summary.txt"
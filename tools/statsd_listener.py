@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Local stand-in for a statsd server, for FrameTelemetry's --telemetry-statsd sink.
+
+Prints every window as one line per scene and metric, e.g.
+    MainScene.frame  count=600 p50=16.67 p90=16.81 p99=33.40 max=50.02 over_budget=4
+and appends the raw datagrams to --log if given.
+
+Usage: statsd_listener.py --port 8125
+       HappyAxmol --telemetry-statsd=127.0.0.1:8125 --telemetry-interval=5
+"""
+
+import argparse
+import socket
+import time
+
+STATS = ("count", "p50", "p90", "p99", "max", "over_budget")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", type=int, default=8125)
+    parser.add_argument("--log", help="append raw datagrams to this file")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("127.0.0.1", args.port))
+    print("statsd_listener: listening on udp://127.0.0.1:%d" % args.port)
+
+    try:
+        while True:
+            datagram = sock.recv(65535).decode(errors="replace")
+            if args.log:
+                with open(args.log, "a") as log:
+                    log.write(datagram + "\n")
+
+            # <prefix>.<scene>.<metric>.<stat>:<value>|<type>
+            rows = {}
+            for line in datagram.splitlines():
+                name, _, rest = line.partition(":")
+                key, _, stat = name.rpartition(".")
+                rows.setdefault(key.partition(".")[2], {})[stat] = rest.partition("|")[0]
+            stamp = time.strftime("%H:%M:%S")
+            for key, values in rows.items():
+                print("%s %-22s %s" % (stamp, key, " ".join("%s=%s" % (s, values.get(s, "-")) for s in STATS)))
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()